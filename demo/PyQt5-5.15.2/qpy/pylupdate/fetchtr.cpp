@@ -58,6 +58,11 @@
 #include <qstring.h>
 #include <qtextstream.h>
 #include <qstack.h>
+#include <qstringlist.h>
+#include <qvector.h>
+#include <qscopedpointer.h>
+#include <qrunnable.h>
+#include <qthreadpool.h>
 
 #include <ctype.h>
 #include <errno.h>
@@ -85,54 +90,100 @@ enum { Tok_Eof, Tok_class, Tok_return, Tok_tr,
        Tok_LeftParen, Tok_RightParen,
        Tok_Comma, Tok_None, Tok_Integer};
 
-// The names of function aliases passed on the command line.
-static const char *tr_function;
-static const char *translate_function;
-
 /*
-  The tokenizer maintains the following global variables. The names
-  should be self-explanatory.
+  The tokenizer and the parser keep all their state in a PythonParser, one
+  per source file, so that several files can be parsed at the same time.
+  The whole file is read in memory before it is tokenized.
 */
-static QByteArray yyFileName;
-static int yyCh;
-static char yyIdent[128];
-static size_t yyIdentLen;
-static char yyComment[65536];
-static size_t yyCommentLen;
-static char yyString[65536];
-static size_t yyStringLen;
-static qlonglong yyInteger;
-static QStack<int> yySavedParenDepth;
-static int yyParenDepth;
-static int yyLineNo;
-static int yyCurLineNo;
-static int yyParenLineNo;
-static QTextCodec *yyCodecForTr = 0;
-static QTextCodec *yyCodecForSource = 0;
-
-// the file to read from (if reading from a file)
-static FILE *yyInFile;
-
-// the string to read from and current position in the string (otherwise)
-static QString yyInStr;
-static int yyInPos;
-// - 'rawbuf' is used to hold bytes before universal newline translation.
-// - 'buf' is its higher-level counterpart, where every end-of-line appears as
-//   a single '\n' character, regardless of the end-of-line style used in input
-//   files.
-static int buf, rawbuf;
-
-static int (*getChar)();
-static int (*peekChar)();
-
-static bool yyParsingUtf8;
-
-static int getTranslatedCharFromFile()
+class PythonParser
+{
+public:
+    PythonParser( const char *fileName, const QByteArray &source,
+                  QTextCodec *codecForTr, QTextCodec *codecForSource,
+                  const char *trFunction, const char *translateFunction );
+
+    void parse( MetaTranslator *tor, const char *initialContext,
+                const char *defaultContext );
+
+private:
+    int getTranslatedChar();
+    int getChar();
+    int peekChar();
+    int getToken();
+
+    bool match( int t );
+    bool matchString( QByteArray *s );
+    bool matchStringOrNone( QByteArray *s );
+    bool matchExpression();
+
+    // The names of function aliases passed on the command line.
+    const char *tr_function;
+    const char *translate_function;
+
+    /*
+      The tokenizer maintains the following variables. The names should be
+      self-explanatory.
+    */
+    QByteArray yyFileName;
+    int yyCh;
+    char yyIdent[128];
+    size_t yyIdentLen;
+    char yyComment[65536];
+    size_t yyCommentLen;
+    char yyString[65536];
+    size_t yyStringLen;
+    qlonglong yyInteger;
+    QStack<int> yySavedParenDepth;
+    int yyParenDepth;
+    int yyLineNo;
+    int yyCurLineNo;
+    int yyParenLineNo;
+    QTextCodec *yyCodecForTr;
+    QTextCodec *yyCodecForSource;
+
+    // The source to read from and the current position in it.
+    QByteArray yyInBuf;
+    const char *yyInPtr;
+    const char *yyInEnd;
+
+    // - 'rawbuf' is used to hold bytes before universal newline translation.
+    // - 'buf' is its higher-level counterpart, where every end-of-line appears
+    //   as a single '\n' character, regardless of the end-of-line style used in
+    //   input files.
+    int buf, rawbuf;
+
+    bool yyParsingUtf8;
+
+    // The current token of the parser.
+    int yyTok;
+};
+
+PythonParser::PythonParser( const char *fileName, const QByteArray &source,
+                            QTextCodec *codecForTr, QTextCodec *codecForSource,
+                            const char *trFunction, const char *translateFunction )
+    : tr_function( trFunction ), translate_function( translateFunction ),
+      yyFileName( fileName ), yyIdentLen( 0 ), yyCommentLen( 0 ),
+      yyStringLen( 0 ), yyInteger( 0 ), yyParenDepth( 0 ), yyLineNo( 1 ),
+      yyCurLineNo( 1 ), yyParenLineNo( 1 ), yyCodecForTr( codecForTr ),
+      yyCodecForSource( codecForSource ), yyInBuf( source ), buf( -1 ),
+      rawbuf( -1 ), yyParsingUtf8( false ), yyTok( Tok_Eof )
+{
+    yyInPtr = yyInBuf.constData();
+    yyInEnd = yyInPtr + yyInBuf.size();
+
+    if (!yyCodecForTr)
+        yyCodecForTr = QTextCodec::codecForName("ISO-8859-1");
+    Q_ASSERT(yyCodecForTr);
+
+    yyCh = getChar();
+}
+
+int PythonParser::getTranslatedChar()
 {
     int c;
 
     if ( rawbuf < 0 )           // Empty raw buffer?
-        c = getc( yyInFile );
+        c = yyInPtr < yyInEnd ? (uchar) *yyInPtr++ : EOF;
     else {
         c = rawbuf;
         rawbuf = -1;            // Declare the raw buffer empty.
@@ -140,7 +191,7 @@ static int getTranslatedCharFromFile()
 
     // Universal newline translation, similar to what Python does
     if ( c == '\r' ) {
-        c = getc( yyInFile ); // Last byte of a \r\n sequence?
+        c = yyInPtr < yyInEnd ? (uchar) *yyInPtr++ : EOF; // Last byte of a \r\n sequence?
         if ( c != '\n')
             {
                 rawbuf = c; // No, put it in 'rawbuf' for later processing.
@@ -153,13 +204,13 @@ static int getTranslatedCharFromFile()
     return c;
 }
 
-static int getCharFromFile()
+int PythonParser::getChar()
 {
     int c;
 
     if (buf < 0 )
     {
-        c = getTranslatedCharFromFile();
+        c = getTranslatedChar();
 
         if (c == '\n')          // This is after universal newline translation
             yyCurLineNo++;      // (i.e., a "logical" newline character).
@@ -173,39 +224,16 @@ static int getCharFromFile()
     return c;
 }
 
-static int peekCharFromFile()
+int PythonParser::peekChar()
 {
     // Read a character, possibly performing universal newline translation,
-    // and put it in 'buf' so that the next call to getCharFromFile() finds it
+    // and put it in 'buf' so that the next call to getChar() finds it
     // already available.
-    buf = getCharFromFile();
+    buf = getChar();
     return buf;
 }
 
-static void startTokenizer( const char *fileName, int (*getCharFunc)(),
-                            int (*peekCharFunc)(), QTextCodec *codecForTr, QTextCodec *codecForSource )
-{
-    yyInPos = 0;
-    buf = rawbuf = -1;
-    getChar = getCharFunc;
-    peekChar = peekCharFunc;
-
-    yyFileName = fileName;
-    yyCh = getChar();
-    yySavedParenDepth.clear();
-    yyParenDepth = 0;
-    yyCurLineNo = 1;
-    yyParenLineNo = 1;
-    yyCodecForTr = codecForTr;
-    if (!yyCodecForTr)
-        yyCodecForTr = QTextCodec::codecForName("ISO-8859-1");
-    Q_ASSERT(yyCodecForTr);
-    yyCodecForSource = codecForSource;
-
-    yyParsingUtf8 = false;
-}
-
-static int getToken()
+int PythonParser::getToken()
 {
     const char tab[] = "abfnrtv";
     const char backTab[] = "\a\b\f\n\r\t\v";
@@ -561,9 +589,7 @@ static int getToken()
   (3) the call appears within a function defined outside the class definition.
 */
 
-static int yyTok;
-
-static bool match( int t )
+bool PythonParser::match( int t )
 {
     bool matches = ( yyTok == t );
     if ( matches )
@@ -571,7 +597,7 @@ static bool match( int t )
     return matches;
 }
 
-static bool matchString( QByteArray *s )
+bool PythonParser::matchString( QByteArray *s )
 {
     bool matches = ( yyTok == Tok_String );
     *s = "";
@@ -582,7 +608,7 @@ static bool matchString( QByteArray *s )
     return matches;
 }
 
-static bool matchStringOrNone(QByteArray *s)
+bool PythonParser::matchStringOrNone(QByteArray *s)
 {
     bool matches = matchString(s);
 
@@ -596,7 +622,7 @@ static bool matchStringOrNone(QByteArray *s)
  * Match any expression that can return a number.  It may match invalid code
  * but it shouldn't fail to match valid code.
  */
-static bool matchExpression()
+bool PythonParser::matchExpression()
 {
     bool matches = false;
 
@@ -645,8 +671,8 @@ static bool matchExpression()
     return matches;
 }
 
-static void parse( MetaTranslator *tor, const char *initialContext,
-           const char *defaultContext )
+void PythonParser::parse( MetaTranslator *tor, const char *initialContext,
+                          const char *defaultContext )
 {
     QMap<QByteArray, QByteArray> qualifiedContexts;
     QByteArray context;
@@ -793,11 +819,10 @@ void fetchtr_py(const char *fileName, MetaTranslator *tor,
         const char *codecForSource, const char *tr_func,
         const char *translate_func)
 {
-    tr_function = tr_func;
-    translate_function = translate_func;
+    FILE *in;
 
 #if defined(_MSC_VER) && _MSC_VER >= 1400
-    if (fopen_s(&yyInFile, fileName, "r")) {
+    if (fopen_s(&in, fileName, "rb")) {
         if ( mustExist ) {
             char buf[100];
             strerror_s(buf, sizeof(buf), errno);
@@ -806,8 +831,8 @@ void fetchtr_py(const char *fileName, MetaTranslator *tor,
                      fileName, buf );
         }
 #else
-    yyInFile = fopen( fileName, "r" );
-    if ( yyInFile == 0 ) {
+    in = fopen( fileName, "rb" );
+    if ( in == 0 ) {
         if ( mustExist )
             fprintf( stderr,
                      "pylupdate5 error: Cannot open Python source file '%s': %s\n",
@@ -816,9 +841,19 @@ void fetchtr_py(const char *fileName, MetaTranslator *tor,
         return;
     }
 
-    startTokenizer( fileName, getCharFromFile, peekCharFromFile, tor->codecForTr(), QTextCodec::codecForName(codecForSource) );
-    parse( tor, 0, defaultContext );
-    fclose( yyInFile );
+    // Read the whole file at once rather than a character at a time.
+    QByteArray source;
+    char chunk[65536];
+    size_t n;
+    while ( (n = fread(chunk, 1, sizeof(chunk), in)) > 0 )
+        source.append( chunk, (int) n );
+    fclose( in );
+
+    // The parser is too large for the stack.
+    QScopedPointer<PythonParser> parser( new PythonParser(fileName, source,
+            tor->codecForTr(), QTextCodec::codecForName(codecForSource),
+            tr_func, translate_func) );
+    parser->parse( tor, 0, defaultContext );
 }
 
 class UiHandler : public QXmlDefaultHandler
@@ -960,3 +995,84 @@ void fetchtr_ui( const char *fileName, MetaTranslator *tor,
     delete hand;
     f.close();
 }
+
+/*
+  Runs the extraction of one file into its own MetaTranslator, so that
+  several files can be processed at the same time.
+*/
+class FetchTask : public QRunnable
+{
+public:
+    FetchTask( const QByteArray &fileName, MetaTranslator *tor,
+               const char *defaultContext, bool mustExist, bool ui,
+               const char *codecForSource, const char *trFunction,
+               const char *translateFunction )
+        : fname( fileName ), tor( tor ), defaultContext( defaultContext ),
+          mustExist( mustExist ), ui( ui ), codecForSource( codecForSource ),
+          trFunction( trFunction ), translateFunction( translateFunction ) { }
+
+    virtual void run()
+    {
+        if ( ui )
+            fetchtr_ui( fname.constData(), tor, defaultContext, mustExist );
+        else
+            fetchtr_py( fname.constData(), tor, defaultContext, mustExist,
+                        codecForSource, trFunction, translateFunction );
+    }
+
+private:
+    QByteArray fname;
+    MetaTranslator *tor;
+    const char *defaultContext;
+    bool mustExist;
+    bool ui;
+    const char *codecForSource;
+    const char *trFunction;
+    const char *translateFunction;
+};
+
+static void fetchtr_files( const QStringList &fileNames, MetaTranslator *tor,
+                           const char *defaultContext, bool mustExist, bool ui,
+                           const char *codecForSource, const char *tr_func,
+                           const char *translate_func )
+{
+    QVector<MetaTranslator> tors( fileNames.size() );
+    QThreadPool pool;
+    QByteArray codecForTr = tor->codecForTr() ? tor->codecForTr()->name()
+                                              : QByteArray( "ISO-8859-1" );
+
+    for ( int i = 0; i < fileNames.size(); i++ ) {
+        tors[i].setCodec( codecForTr.constData() );
+        pool.start( new FetchTask(QFile::encodeName(fileNames.at(i)), &tors[i],
+                                  defaultContext, mustExist, ui,
+                                  codecForSource, tr_func, translate_func) );
+    }
+    pool.waitForDone();
+
+    /*
+      Insert the messages in the order of the files, and of the messages in
+      each file, so that the result is the same as when the files are
+      processed one after the other.
+    */
+    for ( int i = 0; i < tors.size(); i++ ) {
+        const QList<MetaTranslatorMessage> messages = tors.at(i).messages();
+        for ( QList<MetaTranslatorMessage>::ConstIterator it = messages.constBegin();
+              it != messages.constEnd(); ++it )
+            tor->insert( *it );
+    }
+}
+
+void fetchtr_py_files(const QStringList &fileNames, MetaTranslator *tor,
+        const char *defaultContext, bool mustExist,
+        const char *codecForSource, const char *tr_func,
+        const char *translate_func)
+{
+    fetchtr_files( fileNames, tor, defaultContext, mustExist, false,
+                   codecForSource, tr_func, translate_func );
+}
+
+void fetchtr_ui_files(const QStringList &fileNames, MetaTranslator *tor,
+        const char *defaultContext, bool mustExist)
+{
+    fetchtr_files( fileNames, tor, defaultContext, mustExist, true, 0, 0, 0 );
+}
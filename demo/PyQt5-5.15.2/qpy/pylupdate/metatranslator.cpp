@@ -379,13 +379,15 @@ MetaTranslator::MetaTranslator()
 }
 
 MetaTranslator::MetaTranslator( const MetaTranslator& tor )
-    : mm( tor.mm ), codecName( tor.codecName ), codec( tor.codec )
+    : mm( tor.mm ), locationIndexValid( false ), codecName( tor.codecName ),
+      codec( tor.codec )
 {
 }
 
 MetaTranslator& MetaTranslator::operator=( const MetaTranslator& tor )
 {
     mm = tor.mm;
+    invalidateLocationIndex();
     codecName = tor.codecName;
     codec = tor.codec;
     return *this;
@@ -394,6 +396,7 @@ MetaTranslator& MetaTranslator::operator=( const MetaTranslator& tor )
 void MetaTranslator::clear()
 {
     mm.clear();
+    invalidateLocationIndex();
     codecName = "ISO-8859-1";
     codec = 0;
 }
@@ -638,30 +641,53 @@ MetaTranslatorMessage MetaTranslator::find(const char *context, const char *comm
                                 const QString &fileName, int lineNumber) const
 {
     if (lineNumber >= 0 && !fileName.isEmpty()) {
-        MetaTranslatorMessage m;
-
-        for (QMap<MetaTranslatorMessage, int>::const_iterator it = mm.constBegin();
-            it != mm.constEnd(); ++it) {
-            m = it.key();
-            int delta = qstrcmp(m.context(), context);
-            if (delta == 0) {
-                delta = qstrcmp(m.comment(), comment);
-                if (delta == 0) {
-                    delta = QString::compare(m.fileName(), fileName);
-                    if (delta == 0) {
-                        delta = m.lineNumber() - lineNumber;
-                        if (delta == 0)
-                            return m;
-                    }
-                }
+        if (!locationIndexValid) {
+            // Keep the first message in mm for each location.
+            for (TMM::const_iterator it = mm.constBegin(); it != mm.constEnd(); ++it) {
+                const MetaTranslatorMessage &m = it.key();
+                QByteArray key = locationKey(m.context(), m.comment(), m.fileName(), m.lineNumber());
+                if (!locationIndex.contains(key))
+                    locationIndex.insert(key, m);
             }
+            locationIndexValid = true;
         }
+
+        QHash<QByteArray, MetaTranslatorMessage>::const_iterator it =
+            locationIndex.constFind(locationKey(context, comment, fileName, lineNumber));
+        if (it != locationIndex.constEnd())
+            return it.value();
     }
     return MetaTranslatorMessage();
 }
 
+QByteArray MetaTranslator::locationKey(const char *context, const char *comment,
+                                       const QString &fileName, int lineNumber)
+{
+    // Null and empty strings are different locations, as qstrcmp() tells them
+    // apart.
+    QByteArray key;
+    key += context ? '+' : '-';
+    key += context;
+    key += '\0';
+    key += comment ? '+' : '-';
+    key += comment;
+    key += '\0';
+    key += fileName.toUtf8();
+    key += '\0';
+    key += QByteArray::number(lineNumber);
+    return key;
+}
+
+void MetaTranslator::invalidateLocationIndex()
+{
+    locationIndex.clear();
+    locationIndexValid = false;
+}
+
 void MetaTranslator::insert( const MetaTranslatorMessage& m )
 {
+    invalidateLocationIndex();
+
     int pos = mm.count();
     if (mm.contains(m)) {
         pos = mm.value(m);
@@ -680,6 +706,7 @@ void MetaTranslator::stripObsoleteMessages()
         ++m;
     }
     mm = newmm;
+    invalidateLocationIndex();
 }
 
 void MetaTranslator::stripEmptyContexts()
@@ -701,6 +728,7 @@ void MetaTranslator::stripEmptyContexts()
         ++m;
     }
     mm = newmm;
+    invalidateLocationIndex();
 }
 
 void MetaTranslator::makeFileNamesAbsolute(const QDir &oldPath)
@@ -718,6 +746,7 @@ void MetaTranslator::makeFileNamesAbsolute(const QDir &oldPath)
         newmm.insert(msg, m.value());
     }
     mm = newmm;
+    invalidateLocationIndex();
 }
 
 void MetaTranslator::setCodec( const char *name )
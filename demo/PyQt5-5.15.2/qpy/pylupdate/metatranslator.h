@@ -56,6 +56,7 @@
 #define METATRANSLATOR_H
 
 #include <qmap.h>
+#include <qhash.h>
 #include <qstring.h>
 #include <qlist.h>
 #include <qlocale.h>
@@ -161,7 +162,16 @@ private:
     typedef QMap<MetaTranslatorMessage, int> TMM;
     typedef QMap<int, MetaTranslatorMessage> TMMInv;
 
+    static QByteArray locationKey(const char *context, const char *comment,
+                                  const QString &fileName, int lineNumber);
+    void invalidateLocationIndex();
+
     TMM mm;
+    // The messages keyed by their location, so that merging doesn't have to
+    // scan mm for every message whose source text changed.  It is built on
+    // demand and dropped whenever mm changes.
+    mutable QHash<QByteArray, MetaTranslatorMessage> locationIndex;
+    mutable bool locationIndexValid;
     QByteArray codecName;
     QTextCodec *codec;
     QString m_language;     // A string beginning with a 2 or 3 letter language code (ISO 639-1 or ISO-639-2),
@@ -32,6 +32,15 @@ void fetchtr_py(const char *fileName, MetaTranslator *tor,
 void fetchtr_ui(const char *fileName, MetaTranslator *tor,
         const char *defaultContext, bool mustExist);
 
+// These extract the messages of several files using a thread pool.  The
+// messages are added to the translator in the order of the files.
+void fetchtr_py_files(const QStringList &fileNames, MetaTranslator *tor,
+        const char *defaultContext, bool mustExist, const char *codecForSource,
+        const char *tr_func, const char *translate_func);
+
+void fetchtr_ui_files(const QStringList &fileNames, MetaTranslator *tor,
+        const char *defaultContext, bool mustExist);
+
 void merge(const MetaTranslator *tor, const MetaTranslator *virginTor,
         MetaTranslator *out, bool noObsolete, bool verbose,
         const QString &filename);
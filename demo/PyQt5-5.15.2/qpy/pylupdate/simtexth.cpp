@@ -187,6 +187,18 @@ static inline CoMatrix intersection( const CoMatrix& m, const CoMatrix& n )
     return p;
 }
 
+/*
+  The score of two texts, given their co-occurrence matrices and lengths.
+*/
+static inline int similarityScore( const CoMatrix& m, int mLen,
+                                   const CoMatrix& n, int nLen )
+{
+    int delta = qAbs( mLen - nLen );
+
+    return ( (intersection(m, n).worth() + 1) << 10 ) /
+        ( reunion(m, n).worth() + (delta << 1) + 1 );
+}
+
 StringSimilarityMatcher::StringSimilarityMatcher(const QString &stringToMatch)
 {
     m_cm = new CoMatrix( stringToMatch.toLatin1().constData() );
@@ -196,13 +208,8 @@ StringSimilarityMatcher::StringSimilarityMatcher(const QString &stringToMatch)
 int StringSimilarityMatcher::getSimilarityScore(const QString &strCandidate)
 {
     CoMatrix cmTarget( strCandidate.toLatin1().constData() );
-    int targetLen = strCandidate.length();
-    int delta = qAbs( m_length - targetLen );
-    
-    int score = ( (intersection(*m_cm, cmTarget).worth() + 1) << 10 ) /
-        ( reunion(*m_cm, cmTarget).worth() + (delta << 1) + 1 );
 
-    return score;
+    return similarityScore( *m_cm, m_length, cmTarget, strCandidate.length() );
 }
 
 StringSimilarityMatcher::~StringSimilarityMatcher()
@@ -219,14 +226,9 @@ StringSimilarityMatcher::~StringSimilarityMatcher()
 int getSimilarityScore(const QString &str1, const char* str2)
 {
     CoMatrix cmTarget( str2 );
-    int targetLen = qstrlen( str2 );
     CoMatrix cm( str1.toLatin1().constData() );
-    int delta = qAbs( (int) str1.length() - targetLen );
-
-    int score = ( (intersection(cm, cmTarget).worth() + 1) << 10 ) /
-        ( reunion(cm, cmTarget).worth() + (delta << 1) + 1 );
 
-    return score;
+    return similarityScore( cm, str1.length(), cmTarget, qstrlen( str2 ) );
 }
 
 CandidateList similarTextHeuristicCandidates( const MetaTranslator *tor,
@@ -236,15 +238,24 @@ CandidateList similarTextHeuristicCandidates( const MetaTranslator *tor,
     QList<int> scores;
     CandidateList candidates;
 
-    TML all = tor->translatedMessages();
+    /*
+      The matrix of the text to match is the same for every candidate, so
+      build it only once.
+    */
+    CoMatrix cmText( text );
+    int textLen = qstrlen( text );
+
+    const TML all = tor->translatedMessages();
 
-    foreach ( MetaTranslatorMessage mtm, all ) {
+    for ( TML::ConstIterator it = all.constBegin(); it != all.constEnd(); ++it ) {
+        const MetaTranslatorMessage& mtm = *it;
         if ( mtm.type() == MetaTranslatorMessage::Unfinished ||
              mtm.translation().isEmpty() )
             continue;
 
         QString s = tor->toUnicode( mtm.sourceText(), mtm.utf8() );
-        int score = getSimilarityScore(s, text);
+        CoMatrix cm( s.toLatin1().constData() );
+        int score = similarityScore( cm, s.length(), cmText, textLen );
 
         if ( (int) candidates.count() == maxCandidates &&
              score > scores[maxCandidates - 1] )
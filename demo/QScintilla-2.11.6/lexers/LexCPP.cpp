@@ -502,6 +502,12 @@ class LexerCPP : public ILexerWithMetaData {
 	};
 	typedef std::map<std::string, SymbolValue> SymbolTable;
 	SymbolTable preprocessorDefinitionsStart;
+	// The definitions in effect after the first ppDefinitionsCachedCount
+	// entries of ppDefineHistory, left by the previous call to Lex so that
+	// styling a document in consecutive chunks does not replay the history.
+	SymbolTable preprocessorDefinitionsCache;
+	size_t ppDefinitionsCachedCount;
+	bool ppDefinitionsCacheValid;
 	OptionsCPP options;
 	OptionSetCPP osCPP;
 	EscapeSequence escapeSeq;
@@ -518,6 +524,8 @@ public:
 		setArithmethicOp(CharacterSet::setNone, "+-/*%"),
 		setRelOp(CharacterSet::setNone, "=!<>"),
 		setLogicalOp(CharacterSet::setNone, "|&"),
+		ppDefinitionsCachedCount(0),
+		ppDefinitionsCacheValid(false),
 		subStyles(styleSubable, 0x80, 0x40, activeFlag) {
 	}
 	virtual ~LexerCPP() {
@@ -695,6 +703,7 @@ Sci_Position SCI_METHOD LexerCPP::WordListSet(int n, const char *wl) {
 			if (n == 4) {
 				// Rebuild preprocessorDefinitions
 				preprocessorDefinitionsStart.clear();
+				ppDefinitionsCacheValid = false;
 				for (int nDefinition = 0; nDefinition < ppDefinitions.Length(); nDefinition++) {
 					const char *cpDefinition = ppDefinitions.WordAt(nDefinition);
 					const char *cpEquals = strchr(cpDefinition, '=');
@@ -783,15 +792,27 @@ void SCI_METHOD LexerCPP::Lex(Sci_PositionU startPos, Sci_Position length, int i
 	if (!options.updatePreprocessor)
 		ppDefineHistory.clear();
 
-	std::vector<PPDefinition>::iterator itInvalid = std::find_if(ppDefineHistory.begin(), ppDefineHistory.end(),
-		[lineCurrent](const PPDefinition &p) { return p.line >= lineCurrent; });
+	// ppDefineHistory is in line order as lines are lexed forwards.
+	std::vector<PPDefinition>::iterator itInvalid = std::lower_bound(ppDefineHistory.begin(), ppDefineHistory.end(),
+		lineCurrent, [](const PPDefinition &p, Sci_Position line) { return p.line < line; });
 	if (itInvalid != ppDefineHistory.end()) {
 		ppDefineHistory.erase(itInvalid, ppDefineHistory.end());
 		definitionsChanged = true;
 	}
 
-	SymbolTable preprocessorDefinitions = preprocessorDefinitionsStart;
-	for (const PPDefinition &ppDef : ppDefineHistory) {
+	// Start from the definitions left by the previous call when they are
+	// still a prefix of the history, else from preprocessorDefinitionsStart.
+	SymbolTable preprocessorDefinitions;
+	size_t ppDefinitionReplayed = 0;
+	if (ppDefinitionsCacheValid && (ppDefinitionsCachedCount <= ppDefineHistory.size())) {
+		preprocessorDefinitions.swap(preprocessorDefinitionsCache);
+		ppDefinitionReplayed = ppDefinitionsCachedCount;
+	} else {
+		preprocessorDefinitions = preprocessorDefinitionsStart;
+	}
+	ppDefinitionsCacheValid = false;
+	for (size_t i = ppDefinitionReplayed; i < ppDefineHistory.size(); i++) {
+		const PPDefinition &ppDef = ppDefineHistory[i];
 		if (ppDef.isUndef)
 			preprocessorDefinitions.erase(ppDef.key);
 		else
@@ -1365,6 +1386,10 @@ void SCI_METHOD LexerCPP::Lex(Sci_PositionU startPos, Sci_Position length, int i
 	if (definitionsChanged || rawStringsChanged)
 		styler.ChangeLexerState(startPos, startPos + length);
 	sc.Complete();
+
+	preprocessorDefinitionsCache.swap(preprocessorDefinitions);
+	ppDefinitionsCachedCount = ppDefineHistory.size();
+	ppDefinitionsCacheValid = true;
 }
 
 // Store both the current line's fold level and the next lines in the
@@ -67,6 +67,12 @@ enum literalsAllowed { litNone = 0, litU = 1, litB = 2, litF = 4 };
 
 const int indicatorWhitespace = 1;
 
+/* The line state of each line holds the kwLast value at the start of the line
+   and whether an f-string expression stack was saved at the end of the
+   previous line. */
+const int lineStateKwMask = 0x7;
+const int lineStateFStringExp = 0x8;
+
 bool IsPyComment(Accessor &styler, Sci_Position pos, Sci_Position len) {
 	return len > 0 && styler[pos] == '#';
 }
@@ -498,23 +504,15 @@ void SCI_METHOD LexerPython::Lex(Sci_PositionU startPos, Sci_Position length, in
 
 	const Sci_Position endPos = startPos + length;
 
-	// Backtrack to previous line in case need to fix its tab whinging
+	// Backtrack to previous line in case need to fix its tab whinging.
+	// Every line start is a restart point: the style of the previous line end
+	// and the line state (see SetLineState below) hold everything needed to
+	// resume, including backslash-continued strings, so there is no need to
+	// go further back.
 	Sci_Position lineCurrent = styler.GetLine(startPos);
 	if (startPos > 0) {
 		if (lineCurrent > 0) {
 			lineCurrent--;
-			// Look for backslash-continued lines
-			while (lineCurrent > 0) {
-				Sci_Position eolPos = styler.LineStart(lineCurrent) - 1;
-				const int eolStyle = styler.StyleAt(eolPos);
-				if (eolStyle == SCE_P_STRING
-						|| eolStyle == SCE_P_CHARACTER
-						|| eolStyle == SCE_P_STRINGEOL) {
-					lineCurrent -= 1;
-				} else {
-					break;
-				}
-			}
 			startPos = styler.LineStart(lineCurrent);
 		}
 		initStyle = startPos == 0 ? SCE_P_DEFAULT : styler.StyleAt(startPos - 1);
@@ -527,19 +525,23 @@ void SCI_METHOD LexerPython::Lex(Sci_PositionU startPos, Sci_Position length, in
 		initStyle = SCE_P_DEFAULT;
 	}
 
+	const int lineState = (lineCurrent > 0) ? styler.GetLineState(lineCurrent) : 0;
+
 	// Set up fstate stack from last line and remove any subsequent ftriple at eol states
 	std::map<Sci_Position, std::vector<SingleFStringExpState> >::iterator it;
-	it = ftripleStateAtEol.find(lineCurrent - 1);
-	if (it != ftripleStateAtEol.end() && !it->second.empty()) {
-		fstringStateStack = it->second;
-		currentFStringExp = &fstringStateStack.back();
+	if (lineState & lineStateFStringExp) {
+		it = ftripleStateAtEol.find(lineCurrent - 1);
+		if (it != ftripleStateAtEol.end() && !it->second.empty()) {
+			fstringStateStack = it->second;
+			currentFStringExp = &fstringStateStack.back();
+		}
 	}
 	it = ftripleStateAtEol.lower_bound(lineCurrent);
 	if (it != ftripleStateAtEol.end()) {
 		ftripleStateAtEol.erase(it, ftripleStateAtEol.end());
 	}
 
-	kwType kwLast = kwOther;
+	kwType kwLast = static_cast<kwType>(lineState & lineStateKwMask);
 	int spaceFlags = 0;
 	styler.IndentAmount(lineCurrent, &spaceFlags, IsPyComment);
 	bool base_n_number = false;
@@ -555,6 +557,10 @@ void SCI_METHOD LexerPython::Lex(Sci_PositionU startPos, Sci_Position length, in
 	for (; sc.More(); sc.Forward()) {
 
 		if (sc.atLineStart) {
+			// Record what is carried over from the previous line so that
+			// lexing can be restarted here.
+			styler.SetLineState(lineCurrent, kwLast |
+				(fstringStateStack.empty() ? 0 : lineStateFStringExp));
 			styler.IndentAmount(lineCurrent, &spaceFlags, IsPyComment);
 			indentGood = true;
 			if (options.whingeLevel == 1) {
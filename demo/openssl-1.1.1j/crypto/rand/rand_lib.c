@@ -844,6 +844,17 @@ const RAND_METHOD *RAND_get_rand_method(void)
     if (!RUN_ONCE(&rand_init, do_rand_init))
         return NULL;
 
+    /*
+     * Every RAND_bytes() call comes through here, so the common case of a
+     * method already being set only takes the lock for reading, and threads
+     * don't serialize on it.
+     */
+    CRYPTO_THREAD_read_lock(rand_meth_lock);
+    tmp_meth = default_RAND_meth;
+    CRYPTO_THREAD_unlock(rand_meth_lock);
+    if (tmp_meth != NULL)
+        return tmp_meth;
+
     CRYPTO_THREAD_write_lock(rand_meth_lock);
     if (default_RAND_meth == NULL) {
 #ifndef OPENSSL_NO_ENGINE
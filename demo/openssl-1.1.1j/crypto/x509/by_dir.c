@@ -16,21 +16,41 @@
 
 #ifndef OPENSSL_NO_POSIX_IO
 # include <sys/stat.h>
+# ifdef _WIN32
+#  define stat _stat
+# endif
 #endif
 
 #include <openssl/x509.h>
 #include "crypto/x509.h"
 #include "x509_local.h"
 
+/*
+ * Once this many hashes are remembered for a directory, hashes for which no
+ * certificate file was found are no longer added, so that lookups of
+ * arbitrary names can't grow the index without bound.
+ */
+#define BY_DIR_HASH_MAX 1024
+
 struct lookup_dir_hashes_st {
     unsigned long hash;
     int suffix;
+    /*
+     * Modification time of the directory when its certificate or CRL files
+     * for this hash were last probed, or -1 if they must be probed again.
+     */
+    time_t cert_mtime;
+    time_t crl_mtime;
 };
 
 struct lookup_dir_entry_st {
     char *dir;
     int dir_type;
     STACK_OF(BY_DIR_HASH) *hashes;
+    /* Modification time of the directory, or -1 if unknown */
+    time_t mtime;
+    /* When |mtime| was last read */
+    time_t checked;
 };
 
 typedef struct lookup_dir_st {
@@ -192,6 +212,8 @@ static int add_cert_dir(BY_DIR *ctx, const char *dir, int type)
                 return 0;
             }
             ent->dir_type = type;
+            ent->mtime = (time_t)-1;
+            ent->checked = (time_t)-1;
             ent->hashes = sk_BY_DIR_HASH_new(by_dir_hash_cmp);
             ent->dir = OPENSSL_strndup(ss, len);
             if (ent->dir == NULL || ent->hashes == NULL) {
@@ -208,6 +230,34 @@ static int add_cert_dir(BY_DIR *ctx, const char *dir, int type)
     return 1;
 }
 
+#ifndef OPENSSL_NO_POSIX_IO
+/*
+ * Return the modification time of the directory of |ent|, reading it at most
+ * once a second, or -1 if it can't be determined.
+ */
+static time_t by_dir_entry_mtime(BY_DIR *ctx, BY_DIR_ENTRY *ent, time_t now)
+{
+    struct stat st;
+    time_t mtime;
+
+    CRYPTO_THREAD_read_lock(ctx->lock);
+    mtime = ent->mtime;
+    if (ent->checked == now) {
+        CRYPTO_THREAD_unlock(ctx->lock);
+        return mtime;
+    }
+    CRYPTO_THREAD_unlock(ctx->lock);
+
+    mtime = stat(ent->dir, &st) < 0 ? (time_t)-1 : st.st_mtime;
+
+    CRYPTO_THREAD_write_lock(ctx->lock);
+    ent->mtime = mtime;
+    ent->checked = now;
+    CRYPTO_THREAD_unlock(ctx->lock);
+    return mtime;
+}
+#endif
+
 static int get_cert_by_subject(X509_LOOKUP *xl, X509_LOOKUP_TYPE type,
                                X509_NAME *name, X509_OBJECT *ret)
 {
@@ -252,6 +302,7 @@ static int get_cert_by_subject(X509_LOOKUP *xl, X509_LOOKUP_TYPE type,
         BY_DIR_ENTRY *ent;
         int idx;
         BY_DIR_HASH htmp, *hent;
+        time_t now = (time_t)-1, mtime = (time_t)-1, probed = (time_t)-1;
 
         ent = sk_BY_DIR_ENTRY_value(ctx->dirs, i);
         j = strlen(ent->dir) + 1 + 8 + 6 + 1 + 1;
@@ -259,117 +310,163 @@ static int get_cert_by_subject(X509_LOOKUP *xl, X509_LOOKUP_TYPE type,
             X509err(X509_F_GET_CERT_BY_SUBJECT, ERR_R_MALLOC_FAILURE);
             goto finish;
         }
-        if (type == X509_LU_CRL && ent->hashes) {
-            htmp.hash = h;
-            CRYPTO_THREAD_read_lock(ctx->lock);
-            idx = sk_BY_DIR_HASH_find(ent->hashes, &htmp);
-            if (idx >= 0) {
-                hent = sk_BY_DIR_HASH_value(ent->hashes, idx);
+        htmp.hash = h;
+        CRYPTO_THREAD_read_lock(ctx->lock);
+        idx = sk_BY_DIR_HASH_find(ent->hashes, &htmp);
+        if (idx >= 0) {
+            hent = sk_BY_DIR_HASH_value(ent->hashes, idx);
+            if (type == X509_LU_CRL) {
                 k = hent->suffix;
+                probed = hent->crl_mtime;
             } else {
-                hent = NULL;
                 k = 0;
+                probed = hent->cert_mtime;
             }
-            CRYPTO_THREAD_unlock(ctx->lock);
         } else {
-            k = 0;
             hent = NULL;
+            k = 0;
         }
-        for (;;) {
-            char c = '/';
+        CRYPTO_THREAD_unlock(ctx->lock);
+#ifndef OPENSSL_NO_POSIX_IO
+        now = time(NULL);
+        mtime = by_dir_entry_mtime(ctx, ent, now);
+#endif
+        /*
+         * Files are only ever added to the directory by creating new links,
+         * which changes its modification time, so if that hasn't changed
+         * since the files for this hash were last probed, there is nothing
+         * new to load and we can skip straight to the store.  A hash.N file
+         * rewritten in place, or a link whose target is rewritten, doesn't
+         * change the directory and is therefore not reread until something
+         * in the directory itself changes.
+         */
+        if (mtime == (time_t)-1 || probed != mtime) {
+            for (;;) {
+                char c = '/';
 #ifdef OPENSSL_SYS_VMS
-            c = ent->dir[strlen(ent->dir) - 1];
-            if (c != ':' && c != '>' && c != ']') {
-                /*
-                 * If no separator is present, we assume the directory
-                 * specifier is a logical name, and add a colon.  We really
-                 * should use better VMS routines for merging things like
-                 * this, but this will do for now... -- Richard Levitte
-                 */
-                c = ':';
-            } else {
-                c = '\0';
-            }
+                c = ent->dir[strlen(ent->dir) - 1];
+                if (c != ':' && c != '>' && c != ']') {
+                    /*
+                     * If no separator is present, we assume the directory
+                     * specifier is a logical name, and add a colon.  We
+                     * really should use better VMS routines for merging
+                     * things like this, but this will do for now...
+                     * -- Richard Levitte
+                     */
+                    c = ':';
+                } else {
+                    c = '\0';
+                }
 #endif
-            if (c == '\0') {
-                /*
-                 * This is special.  When c == '\0', no directory separator
-                 * should be added.
-                 */
-                BIO_snprintf(b->data, b->max,
-                             "%s%08lx.%s%d", ent->dir, h, postfix, k);
-            } else {
-                BIO_snprintf(b->data, b->max,
-                             "%s%c%08lx.%s%d", ent->dir, c, h, postfix, k);
-            }
+                if (c == '\0') {
+                    /*
+                     * This is special.  When c == '\0', no directory
+                     * separator should be added.
+                     */
+                    BIO_snprintf(b->data, b->max,
+                                 "%s%08lx.%s%d", ent->dir, h, postfix, k);
+                } else {
+                    BIO_snprintf(b->data, b->max,
+                                 "%s%c%08lx.%s%d", ent->dir, c, h, postfix,
+                                 k);
+                }
 #ifndef OPENSSL_NO_POSIX_IO
-# ifdef _WIN32
-#  define stat _stat
-# endif
-            {
-                struct stat st;
-                if (stat(b->data, &st) < 0)
-                    break;
-            }
+                {
+                    struct stat st;
+                    if (stat(b->data, &st) < 0)
+                        break;
+                }
 #endif
-            /* found one. */
-            if (type == X509_LU_X509) {
-                if ((X509_load_cert_file(xl, b->data, ent->dir_type)) == 0)
-                    break;
-            } else if (type == X509_LU_CRL) {
-                if ((X509_load_crl_file(xl, b->data, ent->dir_type)) == 0)
-                    break;
+                /* found one. */
+                if (type == X509_LU_X509) {
+                    if ((X509_load_cert_file(xl, b->data, ent->dir_type)) == 0)
+                        break;
+                } else if (type == X509_LU_CRL) {
+                    if ((X509_load_crl_file(xl, b->data, ent->dir_type)) == 0)
+                        break;
+                }
+                /* else case will caught higher up */
+                k++;
             }
-            /* else case will caught higher up */
-            k++;
-        }
 
-        /*
-         * we have added it to the cache so now pull it out again
-         */
-        X509_STORE_lock(xl->store_ctx);
-        j = sk_X509_OBJECT_find(xl->store_ctx->objs, &stmp);
-        tmp = sk_X509_OBJECT_value(xl->store_ctx->objs, j);
-        X509_STORE_unlock(xl->store_ctx);
-
-        /* If a CRL, update the last file suffix added for this */
+            /*
+             * The probe is only trusted if it started in a later second
+             * than the last change to the directory, as a file added in
+             * the same second wouldn't change its modification time.
+             */
+            if (mtime != (time_t)-1 && mtime < now)
+                probed = mtime;
+            else
+                probed = (time_t)-1;
 
-        if (type == X509_LU_CRL) {
-            CRYPTO_THREAD_write_lock(ctx->lock);
             /*
-             * Look for entry again in case another thread added an entry
-             * first.
+             * If a CRL, update the last file suffix added for this, and
+             * remember when the files for this hash were probed.
              */
-            if (hent == NULL) {
-                htmp.hash = h;
-                idx = sk_BY_DIR_HASH_find(ent->hashes, &htmp);
-                hent = sk_BY_DIR_HASH_value(ent->hashes, idx);
-            }
-            if (hent == NULL) {
-                hent = OPENSSL_malloc(sizeof(*hent));
+            if (type == X509_LU_CRL || probed != (time_t)-1) {
+                CRYPTO_THREAD_write_lock(ctx->lock);
+                /*
+                 * Look for entry again in case another thread added an
+                 * entry first.
+                 */
                 if (hent == NULL) {
-                    CRYPTO_THREAD_unlock(ctx->lock);
-                    X509err(X509_F_GET_CERT_BY_SUBJECT, ERR_R_MALLOC_FAILURE);
-                    ok = 0;
-                    goto finish;
+                    htmp.hash = h;
+                    idx = sk_BY_DIR_HASH_find(ent->hashes, &htmp);
+                    hent = sk_BY_DIR_HASH_value(ent->hashes, idx);
                 }
-                hent->hash = h;
-                hent->suffix = k;
-                if (!sk_BY_DIR_HASH_push(ent->hashes, hent)) {
-                    CRYPTO_THREAD_unlock(ctx->lock);
-                    OPENSSL_free(hent);
-                    X509err(X509_F_GET_CERT_BY_SUBJECT, ERR_R_MALLOC_FAILURE);
-                    ok = 0;
-                    goto finish;
+                if (hent == NULL) {
+                    if (type == X509_LU_X509 && k == 0
+                        && sk_BY_DIR_HASH_num(ent->hashes)
+                           >= BY_DIR_HASH_MAX) {
+                        CRYPTO_THREAD_unlock(ctx->lock);
+                        goto retrieve;
+                    }
+                    hent = OPENSSL_malloc(sizeof(*hent));
+                    if (hent == NULL) {
+                        CRYPTO_THREAD_unlock(ctx->lock);
+                        X509err(X509_F_GET_CERT_BY_SUBJECT,
+                                ERR_R_MALLOC_FAILURE);
+                        ok = 0;
+                        goto finish;
+                    }
+                    hent->hash = h;
+                    hent->suffix = type == X509_LU_CRL ? k : 0;
+                    hent->cert_mtime = (time_t)-1;
+                    hent->crl_mtime = (time_t)-1;
+                    if (!sk_BY_DIR_HASH_push(ent->hashes, hent)) {
+                        CRYPTO_THREAD_unlock(ctx->lock);
+                        OPENSSL_free(hent);
+                        X509err(X509_F_GET_CERT_BY_SUBJECT,
+                                ERR_R_MALLOC_FAILURE);
+                        ok = 0;
+                        goto finish;
+                    }
+                    /*
+                     * Sort while the write lock is held, so that the find
+                     * above under the read lock never has to.
+                     */
+                    sk_BY_DIR_HASH_sort(ent->hashes);
+                } else if (type == X509_LU_CRL && hent->suffix < k) {
+                    hent->suffix = k;
                 }
-            } else if (hent->suffix < k) {
-                hent->suffix = k;
-            }
-
-            CRYPTO_THREAD_unlock(ctx->lock);
+                if (type == X509_LU_CRL)
+                    hent->crl_mtime = probed;
+                else
+                    hent->cert_mtime = probed;
 
+                CRYPTO_THREAD_unlock(ctx->lock);
+            }
         }
 
+ retrieve:
+        /*
+         * we have added it to the cache so now pull it out again
+         */
+        X509_STORE_lock(xl->store_ctx);
+        j = sk_X509_OBJECT_find(xl->store_ctx->objs, &stmp);
+        tmp = sk_X509_OBJECT_value(xl->store_ctx->objs, j);
+        X509_STORE_unlock(xl->store_ctx);
+
         if (tmp != NULL) {
             ok = 1;
             ret->type = tmp->type;
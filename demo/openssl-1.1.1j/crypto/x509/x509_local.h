@@ -97,6 +97,16 @@ struct x509_lookup_st {
     X509_STORE *store_ctx;      /* who owns us */
 };
 
+/*
+ * A chain whose signatures were found good by internal_verify(), identified
+ * by a digest of its certificates and of the verification parameters.
+ */
+typedef struct x509_chain_cache_entry_st {
+    unsigned char key[SHA256_DIGEST_LENGTH];
+    /* When the entry lapses: the earliest notAfter of the chain */
+    time_t expires;
+} X509_CHAIN_CACHE_ENTRY;
+
 /*
  * This is used to hold everything.  It is used for all certificate
  * validation.  Once we have a certificate chain, the 'verify' function is
@@ -134,6 +144,9 @@ struct x509_store_st {
     CRYPTO_EX_DATA ex_data;
     CRYPTO_REF_COUNT references;
     CRYPTO_RWLOCK *lock;
+    /* Verified chains, if enabled with X509_STORE_set_chain_cache_size() */
+    X509_CHAIN_CACHE_ENTRY *chain_cache;
+    int chain_cache_size;
 };
 
 typedef struct lookup_dir_hashes_st BY_DIR_HASH;
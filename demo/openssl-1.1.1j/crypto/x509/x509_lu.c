@@ -226,6 +226,7 @@ void X509_STORE_free(X509_STORE *vfy)
 
     CRYPTO_free_ex_data(CRYPTO_EX_INDEX_X509_STORE, vfy, &vfy->ex_data);
     X509_VERIFY_PARAM_free(vfy->param);
+    OPENSSL_free(vfy->chain_cache);
     CRYPTO_THREAD_lock_free(vfy->lock);
     OPENSSL_free(vfy);
 }
@@ -749,6 +750,35 @@ int X509_STORE_set_flags(X509_STORE *ctx, unsigned long flags)
     return X509_VERIFY_PARAM_set_flags(ctx->param, flags);
 }
 
+/*
+ * Remember up to |size| chains whose signatures have been verified, so that
+ * verifying them again only checks their validity periods.  Zero, the
+ * default, disables the cache.  Any chains already remembered are forgotten.
+ */
+int X509_STORE_set_chain_cache_size(X509_STORE *ctx, int size)
+{
+    X509_CHAIN_CACHE_ENTRY *cache = NULL;
+
+    if (size < 0)
+        return 0;
+    if (size > 0
+            && (cache = OPENSSL_zalloc(sizeof(*cache) * size)) == NULL) {
+        X509err(X509_F_X509_STORE_SET_CHAIN_CACHE_SIZE, ERR_R_MALLOC_FAILURE);
+        return 0;
+    }
+    X509_STORE_lock(ctx);
+    OPENSSL_free(ctx->chain_cache);
+    ctx->chain_cache = cache;
+    ctx->chain_cache_size = size;
+    X509_STORE_unlock(ctx);
+    return 1;
+}
+
+int X509_STORE_get_chain_cache_size(X509_STORE *ctx)
+{
+    return ctx->chain_cache_size;
+}
+
 int X509_STORE_set_depth(X509_STORE *ctx, int depth)
 {
     X509_VERIFY_PARAM_set_depth(ctx->param, depth);
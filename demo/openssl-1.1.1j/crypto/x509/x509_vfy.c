@@ -99,6 +99,8 @@ static int check_crl_chain(X509_STORE_CTX *ctx,
                            STACK_OF(X509) *crl_path);
 
 static int internal_verify(X509_STORE_CTX *ctx);
+static int verify_chain_sigs(X509_STORE_CTX *ctx, int sigs_checked);
+static int chain_cache_verify(X509_STORE_CTX *ctx);
 
 static int null_callback(int ok, X509_STORE_CTX *e)
 {
@@ -230,7 +232,8 @@ static int verify_chain(X509_STORE_CTX *ctx)
     }
 
     /* Verify chain signatures and expiration times */
-    ok = (ctx->verify != NULL) ? ctx->verify(ctx) : internal_verify(ctx);
+    ok = (ctx->verify != NULL && ctx->verify != internal_verify)
+        ? ctx->verify(ctx) : chain_cache_verify(ctx);
     if (!ok)
         return ok;
 
@@ -1725,6 +1728,132 @@ int x509_check_cert_time(X509_STORE_CTX *ctx, X509 *x, int depth)
 
 /* verify the issuer signatures and cert times of ctx->chain */
 static int internal_verify(X509_STORE_CTX *ctx)
+{
+    return verify_chain_sigs(ctx, 0);
+}
+
+/*
+ * Compute the chain cache key of the chain of |ctx| into |key|, and the time
+ * at which the first certificate of the chain expires into |*expires|.
+ * Returns 0 if the chain can't be cached.
+ */
+static int chain_cache_key(X509_STORE_CTX *ctx, unsigned char *key,
+                           time_t *expires)
+{
+    EVP_MD_CTX *mctx;
+    X509_VERIFY_PARAM *param = ctx->param;
+    unsigned char md[EVP_MAX_MD_SIZE];
+    unsigned int mdlen;
+    int params[4];
+    unsigned long flags = param->flags;
+    time_t now = time(NULL), ends;
+    int i, day, sec, ok = 0;
+
+    if ((mctx = EVP_MD_CTX_new()) == NULL
+            || !EVP_DigestInit_ex(mctx, EVP_sha256(), NULL))
+        goto end;
+
+    params[0] = param->purpose;
+    params[1] = param->trust;
+    params[2] = param->depth;
+    params[3] = param->auth_level;
+    if (!EVP_DigestUpdate(mctx, &flags, sizeof(flags))
+            || !EVP_DigestUpdate(mctx, params, sizeof(params)))
+        goto end;
+
+    *expires = (time_t)-1;
+    for (i = 0; i < sk_X509_num(ctx->chain); i++) {
+        X509 *x = sk_X509_value(ctx->chain, i);
+
+        if (!X509_digest(x, EVP_sha256(), md, &mdlen)
+                || !EVP_DigestUpdate(mctx, md, mdlen)
+                || !ASN1_TIME_diff(&day, &sec, NULL, X509_get0_notAfter(x)))
+            goto end;
+        /* Already expired, the chain fails verification anyway */
+        if (day < 0 || sec < 0)
+            goto end;
+        /* Don't risk overflowing time_t for far away dates */
+        if (day > 365)
+            day = 365;
+        ends = now + (time_t)day * 24 * 60 * 60 + sec;
+        if (*expires == (time_t)-1 || ends < *expires)
+            *expires = ends;
+    }
+
+    ok = EVP_DigestFinal_ex(mctx, key, NULL);
+
+ end:
+    EVP_MD_CTX_free(mctx);
+    return ok;
+}
+
+/*
+ * Verify the chain of |ctx| like internal_verify(), except that when the
+ * store has a chain cache and the same chain was already verified with the
+ * same parameters, the signatures are not checked again.  Validity periods
+ * are always checked, and the callback notified, at each depth.
+ */
+static int chain_cache_verify(X509_STORE_CTX *ctx)
+{
+    X509_STORE *store = ctx->ctx;
+    X509_CHAIN_CACHE_ENTRY *ent;
+    unsigned char key[SHA256_DIGEST_LENGTH];
+    time_t expires;
+    int err = ctx->error;
+    int ok, slot;
+
+    /*
+     * Custom issuer checks and DANE bare key signatures are outside what
+     * the key describes.
+     */
+    if (store == NULL || ctx->check_issued != check_issued
+            || ctx->bare_ta_signed)
+        return verify_chain_sigs(ctx, 0);
+
+    CRYPTO_THREAD_read_lock(store->lock);
+    ok = store->chain_cache != NULL;
+    CRYPTO_THREAD_unlock(store->lock);
+    if (!ok || !chain_cache_key(ctx, key, &expires))
+        return verify_chain_sigs(ctx, 0);
+
+    slot = (int)(((unsigned int)key[0] << 24 | (unsigned int)key[1] << 16
+                  | (unsigned int)key[2] << 8 | key[3]) & 0x7fffffff);
+
+    CRYPTO_THREAD_read_lock(store->lock);
+    ok = 0;
+    if (store->chain_cache != NULL) {
+        ent = &store->chain_cache[slot % store->chain_cache_size];
+        ok = ent->expires > time(NULL)
+            && memcmp(ent->key, key, sizeof(key)) == 0;
+    }
+    CRYPTO_THREAD_unlock(store->lock);
+    if (ok)
+        return verify_chain_sigs(ctx, 1);
+
+    ok = verify_chain_sigs(ctx, 0);
+
+    /*
+     * Only remember chains which passed without any error being overridden
+     * by the callback, before or during the signature checks.
+     */
+    if (ok && err == X509_V_OK && ctx->error == X509_V_OK) {
+        CRYPTO_THREAD_write_lock(store->lock);
+        if (store->chain_cache != NULL) {
+            ent = &store->chain_cache[slot % store->chain_cache_size];
+            memcpy(ent->key, key, sizeof(key));
+            ent->expires = expires;
+        }
+        CRYPTO_THREAD_unlock(store->lock);
+    }
+    return ok;
+}
+
+/*
+ * Check the signatures and validity periods of the chain of |ctx|, skipping
+ * the signatures (and the issuer key checks that go with them) if
+ * |sigs_checked| is set because they are already known to be good.
+ */
+static int verify_chain_sigs(X509_STORE_CTX *ctx, int sigs_checked)
 {
     int n = sk_X509_num(ctx->chain) - 1;
     X509 *xi = sk_X509_value(ctx->chain, n);
@@ -1777,8 +1906,10 @@ static int internal_verify(X509_STORE_CTX *ctx)
          * Skip signature check for self-signed certificates unless explicitly
          * asked for because it does not add any security and just wastes time.
          */
-        if (xs != xi || ((ctx->param->flags & X509_V_FLAG_CHECK_SS_SIGNATURE)
-                         && (xi->ex_flags & EXFLAG_SS) != 0)) {
+        if (!sigs_checked
+            && (xs != xi
+                || ((ctx->param->flags & X509_V_FLAG_CHECK_SS_SIGNATURE)
+                    && (xi->ex_flags & EXFLAG_SS) != 0))) {
             EVP_PKEY *pkey;
             /*
              * If the issuer's public key is not available or its key usage
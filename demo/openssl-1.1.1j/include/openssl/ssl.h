@@ -506,6 +506,12 @@ typedef int (*SSL_verify_cb)(int preverify_ok, X509_STORE_CTX *x509_ctx);
  * - OpenSSL 1.1.1 and 1.1.1a
  */
 # define SSL_MODE_DTLS_SCTP_LABEL_LENGTH_BUG 0x00000400U
+/*
+ * Let SSL_write() encrypt several full records into one buffer and hand them
+ * to the BIO in a single write, rather than one write per record. This
+ * needs a write buffer several records long. (TLS only.)
+ */
+# define SSL_MODE_BATCH_WRITES 0x00000800U
 
 /* Cert related flags */
 /*
@@ -78,6 +78,7 @@ int ERR_load_X509_strings(void);
 # define X509_F_X509_STORE_CTX_NEW                        142
 # define X509_F_X509_STORE_CTX_PURPOSE_INHERIT            134
 # define X509_F_X509_STORE_NEW                            158
+# define X509_F_X509_STORE_SET_CHAIN_CACHE_SIZE           162
 # define X509_F_X509_TO_X509_REQ                          126
 # define X509_F_X509_TRUST_ADD                            133
 # define X509_F_X509_TRUST_SET                            141
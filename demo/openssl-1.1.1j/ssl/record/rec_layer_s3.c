@@ -26,6 +26,9 @@
 # define EVP_CIPH_FLAG_TLS1_1_MULTIBLOCK 0
 #endif
 
+/* Most records collected into one write with SSL_MODE_BATCH_WRITES */
+#define SSL3_WRITE_BATCH_MAX_RECORDS 8
+
 void RECORD_LAYER_init(RECORD_LAYER *rl, SSL *s)
 {
     rl->s = s;
@@ -46,6 +49,7 @@ void RECORD_LAYER_clear(RECORD_LAYER *rl)
     rl->packet = NULL;
     rl->packet_length = 0;
     rl->wnum = 0;
+    rl->wbatch = 0;
     memset(rl->handshake_fragment, 0, sizeof(rl->handshake_fragment));
     rl->handshake_fragment_len = 0;
     rl->wpend_tot = 0;
@@ -587,6 +591,92 @@ int ssl3_write_bytes(SSL *s, int type, const void *buf_, size_t len,
         return -1;
     }
 
+    /*
+     * Without pipelining each record goes out in its own BIO write. In batch
+     * mode full records are instead encrypted one after the other into a
+     * single buffer, which is then written out at once. Whatever is left
+     * over once less than two full records remain goes through the normal
+     * path below.
+     */
+    if ((s->mode & SSL_MODE_BATCH_WRITES) != 0
+            && maxpipes == 1
+            && type == SSL3_RT_APPLICATION_DATA
+            && s->compress == NULL
+            && !s->s3->need_empty_fragments) {
+        size_t reclen = max_send_fragment + SSL3_RT_HEADER_LENGTH
+                        + SSL3_RT_SEND_MAX_ENCRYPTED_OVERHEAD;
+        size_t align = 0;
+
+#if defined(SSL3_ALIGN_PAYLOAD) && SSL3_ALIGN_PAYLOAD != 0
+        align = SSL3_ALIGN_PAYLOAD - 1;
+#endif
+
+        while (n >= 2 * max_send_fragment) {
+            size_t numrecs = n / max_send_fragment, nw, j;
+            size_t packlen;
+
+            if (numrecs > SSL3_WRITE_BATCH_MAX_RECORDS)
+                numrecs = SSL3_WRITE_BATCH_MAX_RECORDS;
+            packlen = numrecs * reclen + align;
+
+            if (wb->buf == NULL || wb->len < packlen) {
+                ssl3_release_write_buffer(s);
+                if (!ssl3_setup_write_buffer(s, 1, packlen)) {
+                    /* SSLfatal() already called */
+                    return -1;
+                }
+            }
+
+            if (s->s3->alert_dispatch) {
+                i = s->method->ssl_dispatch_alert(s);
+                if (i <= 0) {
+                    /* SSLfatal() already called if appropriate */
+                    s->rlayer.wnum = tot;
+                    return i;
+                }
+            }
+
+            s->rlayer.wbatch = 1;
+            for (j = 0; j < numrecs; j++) {
+                size_t fraglen = max_send_fragment;
+
+                i = do_ssl3_write(s, type, &buf[tot + j * max_send_fragment],
+                                  &fraglen, 1, 0, &tmpwrit);
+                if (i <= 0) {
+                    /* SSLfatal() already called if appropriate */
+                    s->rlayer.wbatch = 0;
+                    SSL3_BUFFER_set_left(wb, 0);
+                    s->rlayer.wnum = tot;
+                    return i;
+                }
+            }
+            s->rlayer.wbatch = 0;
+
+            nw = numrecs * max_send_fragment;
+            s->rlayer.wpend_tot = nw;
+            s->rlayer.wpend_buf = &buf[tot];
+            s->rlayer.wpend_type = type;
+            s->rlayer.wpend_ret = nw;
+
+            i = ssl3_write_pending(s, type, &buf[tot], nw, &tmpwrit);
+            if (i <= 0) {
+                /* SSLfatal() already called if appropriate */
+                s->rlayer.wnum = tot;
+                return i;
+            }
+
+            if (tmpwrit == n || (s->mode & SSL_MODE_ENABLE_PARTIAL_WRITE)) {
+                if (tmpwrit == n && (s->mode & SSL_MODE_RELEASE_BUFFERS) != 0)
+                    ssl3_release_write_buffer(s);
+                *written = tot + tmpwrit;
+                return 1;
+            }
+
+            n -= tmpwrit;
+            tot += tmpwrit;
+        }
+    }
+
     for (;;) {
         size_t pipelens[SSL_MAX_PIPELINES], tmppipelen, remain;
         size_t numpipes, j;
@@ -669,17 +759,24 @@ int do_ssl3_write(SSL *s, int type, const unsigned char *buf,
 
     for (j = 0; j < numpipes; j++)
         totlen += pipelens[j];
-    /*
-     * first check if there is a SSL3_BUFFER still being written out.  This
-     * will happen with non blocking IO
-     */
-    if (RECORD_LAYER_write_pending(&s->rlayer)) {
+
+    if (s->rlayer.wbatch) {
+        /*
+         * Append this record to the ones already collected in the batch, as
+         * is done for the empty fragment below
+         */
+        prefix_len = SSL3_BUFFER_get_left(&s->rlayer.wbuf[0]);
+    } else if (RECORD_LAYER_write_pending(&s->rlayer)) {
+        /*
+         * first check if there is a SSL3_BUFFER still being written out.
+         * This will happen with non blocking IO
+         */
         /* Calls SSLfatal() as required */
         return ssl3_write_pending(s, type, buf, totlen, written);
     }
 
     /* If we have an alert to send, lets send it */
-    if (s->s3->alert_dispatch) {
+    if (s->s3->alert_dispatch && !s->rlayer.wbatch) {
         i = s->method->ssl_dispatch_alert(s);
         if (i <= 0) {
             /* SSLfatal() already called if appropriate */
@@ -1111,6 +1208,12 @@ int do_ssl3_write(SSL *s, int type, const unsigned char *buf,
     s->rlayer.wpend_type = type;
     s->rlayer.wpend_ret = totlen;
 
+    if (s->rlayer.wbatch) {
+        /* The caller writes the whole batch out */
+        *written = totlen;
+        return 1;
+    }
+
     /* we now just need to write the buffer */
     return ssl3_write_pending(s, type, buf, totlen, written);
  err:
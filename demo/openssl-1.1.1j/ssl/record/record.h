@@ -149,6 +149,11 @@ typedef struct record_layer_st {
     size_t packet_length;
     /* number of bytes sent so far */
     size_t wnum;
+    /*
+     * Set while ssl3_write_bytes() is collecting a batch of records in
+     * wbuf[0]: do_ssl3_write() then appends to the buffer instead of writing
+     */
+    int wbatch;
     unsigned char handshake_fragment[4];
     size_t handshake_fragment_len;
     /* The number of consecutive empty records we have received */
@@ -924,6 +924,7 @@ int SSL_has_matching_session_id(const SSL *ssl, const unsigned char *id,
      * by this SSL.
      */
     SSL_SESSION r, *p;
+    SSL_SESSION_CACHE_SHARD *shard;
 
     if (id_len > sizeof(r.session_id))
         return 0;
@@ -932,9 +933,10 @@ int SSL_has_matching_session_id(const SSL *ssl, const unsigned char *id,
     r.session_id_length = id_len;
     memcpy(r.session_id, id, id_len);
 
-    CRYPTO_THREAD_read_lock(ssl->session_ctx->lock);
-    p = lh_SSL_SESSION_retrieve(ssl->session_ctx->sessions, &r);
-    CRYPTO_THREAD_unlock(ssl->session_ctx->lock);
+    shard = ssl_session_cache_shard(ssl->session_ctx, id, id_len);
+    CRYPTO_THREAD_read_lock(shard->lock);
+    p = lh_SSL_SESSION_retrieve(shard->sessions, &r);
+    CRYPTO_THREAD_unlock(shard->lock);
     return (p != NULL);
 }
 
@@ -2273,9 +2275,15 @@ long SSL_callback_ctrl(SSL *s, int cmd, void (*fp) (void))
     }
 }
 
+/*
+ * Returns the live table of the internal session cache. The cache has a
+ * single shard unless libssl is built with SSL_SESSION_CACHE_SHARDS set above
+ * 1; such a build opts out of this function, which then only returns the
+ * table of the first shard.
+ */
 LHASH_OF(SSL_SESSION) *SSL_CTX_sessions(SSL_CTX *ctx)
 {
-    return ctx->sessions;
+    return ctx->sessions[0].sessions;
 }
 
 long SSL_CTX_ctrl(SSL_CTX *ctx, int cmd, long larg, void *parg)
@@ -2333,7 +2341,7 @@ long SSL_CTX_ctrl(SSL_CTX *ctx, int cmd, long larg, void *parg)
         return ctx->session_cache_mode;
 
     case SSL_CTRL_SESS_NUMBER:
-        return lh_SSL_SESSION_num_items(ctx->sessions);
+        return (long)ssl_session_cache_num_items(ctx);
     case SSL_CTRL_SESS_CONNECT:
         return tsan_load(&ctx->stats.sess_connect);
     case SSL_CTRL_SESS_CONNECT_GOOD:
@@ -2964,6 +2972,7 @@ static int ssl_session_cmp(const SSL_SESSION *a, const SSL_SESSION *b)
 SSL_CTX *SSL_CTX_new(const SSL_METHOD *meth)
 {
     SSL_CTX *ret = NULL;
+    int i;
 
     if (meth == NULL) {
         SSLerr(SSL_F_SSL_CTX_NEW, SSL_R_NULL_SSL_METHOD_PASSED);
@@ -3001,9 +3010,14 @@ SSL_CTX *SSL_CTX_new(const SSL_METHOD *meth)
     if ((ret->cert = ssl_cert_new()) == NULL)
         goto err;
 
-    ret->sessions = lh_SSL_SESSION_new(ssl_session_hash, ssl_session_cmp);
-    if (ret->sessions == NULL)
-        goto err;
+    for (i = 0; i < SSL_SESSION_CACHE_SHARDS; i++) {
+        SSL_SESSION_CACHE_SHARD *shard = &ret->sessions[i];
+
+        shard->lock = CRYPTO_THREAD_lock_new();
+        shard->sessions = lh_SSL_SESSION_new(ssl_session_hash, ssl_session_cmp);
+        if (shard->lock == NULL || shard->sessions == NULL)
+            goto err;
+    }
     ret->cert_store = X509_STORE_new();
     if (ret->cert_store == NULL)
         goto err;
@@ -3187,11 +3201,13 @@ void SSL_CTX_free(SSL_CTX *a)
      * free ex_data, then finally free the cache.
      * (See ticket [openssl.org #212].)
      */
-    if (a->sessions != NULL)
-        SSL_CTX_flush_sessions(a, 0);
+    SSL_CTX_flush_sessions(a, 0);
 
     CRYPTO_free_ex_data(CRYPTO_EX_INDEX_SSL_CTX, a, &a->ex_data);
-    lh_SSL_SESSION_free(a->sessions);
+    for (i = 0; i < SSL_SESSION_CACHE_SHARDS; i++) {
+        lh_SSL_SESSION_free(a->sessions[i].sessions);
+        CRYPTO_THREAD_lock_free(a->sessions[i].lock);
+    }
     X509_STORE_free(a->cert_store);
 #ifndef OPENSSL_NO_CT
     CTLOG_STORE_free(a->ctlog_store);
@@ -727,6 +727,29 @@ DEFINE_LHASH_OF(X509_NAME);
 # define TLSEXT_KEYNAME_LENGTH  16
 # define TLSEXT_TICK_KEY_LENGTH 32
 
+/*
+ * The internal session cache can be split into this many shards, selected by
+ * session ID, each with its own lock, hash table and LRU list, so that
+ * concurrent lookups and insertions of different sessions don't contend.
+ * Sharding is opt-in: with more than one shard SSL_CTX_sessions() only sees
+ * the first shard. The cache size is enforced across shards through an
+ * atomic count, so builds without native atomics keep a single shard.
+ */
+# ifndef SSL_SESSION_CACHE_SHARDS
+#  define SSL_SESSION_CACHE_SHARDS 1
+# endif
+# if SSL_SESSION_CACHE_SHARDS > 1 && !defined(tsan_ld_acq)
+#  undef SSL_SESSION_CACHE_SHARDS
+#  define SSL_SESSION_CACHE_SHARDS 1
+# endif
+
+typedef struct ssl_session_cache_shard_st {
+    CRYPTO_RWLOCK *lock;
+    LHASH_OF(SSL_SESSION) *sessions;
+    struct ssl_session_st *session_cache_head;
+    struct ssl_session_st *session_cache_tail;
+} SSL_SESSION_CACHE_SHARD;
+
 typedef struct ssl_ctx_ext_secure_st {
     unsigned char tick_hmac_key[TLSEXT_TICK_KEY_LENGTH];
     unsigned char tick_aes_key[TLSEXT_TICK_KEY_LENGTH];
@@ -740,14 +763,15 @@ struct ssl_ctx_st {
     /* TLSv1.3 specific ciphersuites */
     STACK_OF(SSL_CIPHER) *tls13_ciphersuites;
     struct x509_store_st /* X509_STORE */ *cert_store;
-    LHASH_OF(SSL_SESSION) *sessions;
+    SSL_SESSION_CACHE_SHARD sessions[SSL_SESSION_CACHE_SHARDS];
+    /* Number of sessions held by all the shards together */
+    TSAN_QUALIFIER int sessions_num;
     /*
      * Most session-ids that will be cached, default is
-     * SSL_SESSION_CACHE_MAX_SIZE_DEFAULT. 0 is unlimited.
+     * SSL_SESSION_CACHE_MAX_SIZE_DEFAULT. 0 is unlimited. This bounds the
+     * total over all shards, not each shard on its own.
      */
     size_t session_cache_size;
-    struct ssl_session_st *session_cache_head;
-    struct ssl_session_st *session_cache_tail;
     /*
      * This can have one of 2 values, ored together, SSL_SESS_CACHE_CLIENT,
      * SSL_SESS_CACHE_SERVER, Default is SSL_SESSION_CACHE_SERVER, which
@@ -2260,6 +2284,10 @@ __owur int ssl_generate_session_id(SSL *s, SSL_SESSION *ss);
 __owur int ssl_get_new_session(SSL *s, int session);
 __owur SSL_SESSION *lookup_sess_in_cache(SSL *s, const unsigned char *sess_id,
                                          size_t sess_id_len);
+__owur SSL_SESSION_CACHE_SHARD *ssl_session_cache_shard(SSL_CTX *ctx,
+                                                        const unsigned char *id,
+                                                        size_t id_len);
+__owur size_t ssl_session_cache_num_items(SSL_CTX *ctx);
 __owur int ssl_get_prev_session(SSL *s, CLIENTHELLO_MSG *hello);
 __owur SSL_SESSION *ssl_session_dup(SSL_SESSION *src, int ticket);
 __owur int ssl_cipher_id_cmp(const SSL_CIPHER *a, const SSL_CIPHER *b);
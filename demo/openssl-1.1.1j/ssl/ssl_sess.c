@@ -16,8 +16,10 @@
 #include "ssl_local.h"
 #include "statem/statem_local.h"
 
-static void SSL_SESSION_list_remove(SSL_CTX *ctx, SSL_SESSION *s);
-static void SSL_SESSION_list_add(SSL_CTX *ctx, SSL_SESSION *s);
+static void SSL_SESSION_list_remove(SSL_SESSION_CACHE_SHARD *shard,
+                                    SSL_SESSION *s);
+static void SSL_SESSION_list_add(SSL_SESSION_CACHE_SHARD *shard,
+                                 SSL_SESSION *s);
 static int remove_session_lock(SSL_CTX *ctx, SSL_SESSION *c, int lck);
 
 /*
@@ -416,6 +418,71 @@ int ssl_get_new_session(SSL *s, int session)
     return 1;
 }
 
+/*
+ * Returns the shard of |ctx|'s session cache that holds sessions with the
+ * given ID. ssl_session_hash() uses the first four bytes of the ID to pick a
+ * bucket, so the shard is chosen from the last byte to keep the two
+ * independent for IDs that are longer than that.
+ */
+SSL_SESSION_CACHE_SHARD *ssl_session_cache_shard(SSL_CTX *ctx,
+                                                 const unsigned char *sess_id,
+                                                 size_t sess_id_len)
+{
+    if (sess_id_len <= 4)
+        return &ctx->sessions[0];
+    return &ctx->sessions[sess_id[sess_id_len - 1]
+                          % SSL_SESSION_CACHE_SHARDS];
+}
+
+/*
+ * Adds |delta|, which is -1, 0 or 1, to the number of sessions held by all
+ * the shards of |ctx|'s session cache and returns the new total. The caller
+ * holds the lock of the shard it is changing, if any. Other shards change
+ * concurrently, so the count is kept with lock-free atomics rather than
+ * behind a lock shared by all the shards.
+ */
+static int ssl_session_cache_count(SSL_CTX *ctx, int delta)
+{
+    if (delta > 0)
+        return tsan_counter(&ctx->sessions_num) + 1;
+    if (delta < 0)
+        return tsan_decr(&ctx->sessions_num) - 1;
+    return tsan_load(&ctx->sessions_num);
+}
+
+size_t ssl_session_cache_num_items(SSL_CTX *ctx)
+{
+    return (size_t)ssl_session_cache_count(ctx, 0);
+}
+
+/*
+ * Removes the oldest sessions of the shards other than |skip| until the
+ * cache is back within its configured size. Called without any shard lock
+ * held; each shard is locked in turn.
+ */
+static void ssl_session_cache_trim(SSL_CTX *ctx, SSL_SESSION_CACHE_SHARD *skip)
+{
+    long size = SSL_CTX_sess_get_cache_size(ctx);
+    size_t i;
+
+    for (i = 0; i < SSL_SESSION_CACHE_SHARDS; i++) {
+        SSL_SESSION_CACHE_SHARD *shard = &ctx->sessions[i];
+
+        if (size <= 0 || ssl_session_cache_count(ctx, 0) <= size)
+            return;
+        if (shard == skip)
+            continue;
+        CRYPTO_THREAD_write_lock(shard->lock);
+        while (shard->session_cache_tail != NULL
+               && ssl_session_cache_count(ctx, 0) > size) {
+            if (!remove_session_lock(ctx, shard->session_cache_tail, 0))
+                break;
+            tsan_counter(&ctx->stats.sess_cache_full);
+        }
+        CRYPTO_THREAD_unlock(shard->lock);
+    }
+}
+
 SSL_SESSION *lookup_sess_in_cache(SSL *s, const unsigned char *sess_id,
                                   size_t sess_id_len)
 {
@@ -424,6 +491,7 @@ SSL_SESSION *lookup_sess_in_cache(SSL *s, const unsigned char *sess_id,
     if ((s->session_ctx->session_cache_mode
          & SSL_SESS_CACHE_NO_INTERNAL_LOOKUP) == 0) {
         SSL_SESSION data;
+        SSL_SESSION_CACHE_SHARD *shard;
 
         data.ssl_version = s->version;
         if (!ossl_assert(sess_id_len <= SSL_MAX_SSL_SESSION_ID_LENGTH))
@@ -432,13 +500,14 @@ SSL_SESSION *lookup_sess_in_cache(SSL *s, const unsigned char *sess_id,
         memcpy(data.session_id, sess_id, sess_id_len);
         data.session_id_length = sess_id_len;
 
-        CRYPTO_THREAD_read_lock(s->session_ctx->lock);
-        ret = lh_SSL_SESSION_retrieve(s->session_ctx->sessions, &data);
+        shard = ssl_session_cache_shard(s->session_ctx, sess_id, sess_id_len);
+        CRYPTO_THREAD_read_lock(shard->lock);
+        ret = lh_SSL_SESSION_retrieve(shard->sessions, &data);
         if (ret != NULL) {
             /* don't allow other threads to steal it: */
             SSL_SESSION_up_ref(ret);
         }
-        CRYPTO_THREAD_unlock(s->session_ctx->lock);
+        CRYPTO_THREAD_unlock(shard->lock);
         if (ret == NULL)
             tsan_counter(&s->session_ctx->stats.sess_miss);
     }
@@ -637,7 +706,9 @@ int ssl_get_prev_session(SSL *s, CLIENTHELLO_MSG *hello)
 int SSL_CTX_add_session(SSL_CTX *ctx, SSL_SESSION *c)
 {
     int ret = 0;
+    int trim = 0;
     SSL_SESSION *s;
+    SSL_SESSION_CACHE_SHARD *shard;
 
     /*
      * add just 1 reference count for the SSL_CTX's session cache even though
@@ -649,18 +720,20 @@ int SSL_CTX_add_session(SSL_CTX *ctx, SSL_SESSION *c)
      * if session c is in already in cache, we take back the increment later
      */
 
-    CRYPTO_THREAD_write_lock(ctx->lock);
-    s = lh_SSL_SESSION_insert(ctx->sessions, c);
+    shard = ssl_session_cache_shard(ctx, c->session_id, c->session_id_length);
+    CRYPTO_THREAD_write_lock(shard->lock);
+    s = lh_SSL_SESSION_insert(shard->sessions, c);
 
     /*
      * s != NULL iff we already had a session with the given PID. In this
      * case, s == c should hold (then we did not really modify
-     * ctx->sessions), or we're in trouble.
+     * shard->sessions), or we're in trouble.
      */
     if (s != NULL && s != c) {
         /* We *are* in trouble ... */
-        SSL_SESSION_list_remove(ctx, s);
+        SSL_SESSION_list_remove(shard, s);
         SSL_SESSION_free(s);
+        ssl_session_cache_count(ctx, -1);
         /*
          * ... so pretend the other session did not exist in cache (we cannot
          * handle two SSL_SESSION structures with identical session ID in the
@@ -669,7 +742,7 @@ int SSL_CTX_add_session(SSL_CTX *ctx, SSL_SESSION *c)
          */
         s = NULL;
     } else if (s == NULL &&
-               lh_SSL_SESSION_retrieve(ctx->sessions, c) == NULL) {
+               lh_SSL_SESSION_retrieve(shard->sessions, c) == NULL) {
         /* s == NULL can also mean OOM error in lh_SSL_SESSION_insert ... */
 
         /*
@@ -681,7 +754,7 @@ int SSL_CTX_add_session(SSL_CTX *ctx, SSL_SESSION *c)
 
     /* Put at the head of the queue unless it is already in the cache */
     if (s == NULL)
-        SSL_SESSION_list_add(ctx, c);
+        SSL_SESSION_list_add(shard, c);
 
     if (s != NULL) {
         /*
@@ -693,21 +766,29 @@ int SSL_CTX_add_session(SSL_CTX *ctx, SSL_SESSION *c)
         ret = 0;
     } else {
         /*
-         * new cache entry -- remove old ones if cache has become too large
+         * new cache entry -- remove old ones if the cache has grown beyond
+         * its size. This shard's oldest sessions go first, but never |c|
+         * itself; if that isn't enough the other shards are trimmed once
+         * our lock has been dropped.
          */
+        long size = SSL_CTX_sess_get_cache_size(ctx);
+        int total = ssl_session_cache_count(ctx, 1);
 
         ret = 1;
 
-        if (SSL_CTX_sess_get_cache_size(ctx) > 0) {
-            while (SSL_CTX_sess_number(ctx) > SSL_CTX_sess_get_cache_size(ctx)) {
-                if (!remove_session_lock(ctx, ctx->session_cache_tail, 0))
+        if (size > 0) {
+            while (total > size && shard->session_cache_tail != c) {
+                if (!remove_session_lock(ctx, shard->session_cache_tail, 0))
                     break;
-                else
-                    tsan_counter(&ctx->stats.sess_cache_full);
+                tsan_counter(&ctx->stats.sess_cache_full);
+                total = ssl_session_cache_count(ctx, 0);
             }
+            trim = total > size;
         }
     }
-    CRYPTO_THREAD_unlock(ctx->lock);
+    CRYPTO_THREAD_unlock(shard->lock);
+    if (trim)
+        ssl_session_cache_trim(ctx, shard);
     return ret;
 }
 
@@ -719,20 +800,24 @@ int SSL_CTX_remove_session(SSL_CTX *ctx, SSL_SESSION *c)
 static int remove_session_lock(SSL_CTX *ctx, SSL_SESSION *c, int lck)
 {
     SSL_SESSION *r;
+    SSL_SESSION_CACHE_SHARD *shard;
     int ret = 0;
 
     if ((c != NULL) && (c->session_id_length != 0)) {
+        shard = ssl_session_cache_shard(ctx, c->session_id,
+                                        c->session_id_length);
         if (lck)
-            CRYPTO_THREAD_write_lock(ctx->lock);
-        if ((r = lh_SSL_SESSION_retrieve(ctx->sessions, c)) != NULL) {
+            CRYPTO_THREAD_write_lock(shard->lock);
+        if ((r = lh_SSL_SESSION_retrieve(shard->sessions, c)) != NULL) {
             ret = 1;
-            r = lh_SSL_SESSION_delete(ctx->sessions, r);
-            SSL_SESSION_list_remove(ctx, r);
+            r = lh_SSL_SESSION_delete(shard->sessions, r);
+            SSL_SESSION_list_remove(shard, r);
+            ssl_session_cache_count(ctx, -1);
         }
         c->not_resumable = 1;
 
         if (lck)
-            CRYPTO_THREAD_unlock(ctx->lock);
+            CRYPTO_THREAD_unlock(shard->lock);
 
         if (ctx->remove_session_cb != NULL)
             ctx->remove_session_cb(ctx, c);
@@ -1045,7 +1130,7 @@ int SSL_set_session_ticket_ext(SSL *s, void *ext_data, int ext_len)
 typedef struct timeout_param_st {
     SSL_CTX *ctx;
     long time;
-    LHASH_OF(SSL_SESSION) *cache;
+    SSL_SESSION_CACHE_SHARD *shard;
 } TIMEOUT_PARAM;
 
 static void timeout_cb(SSL_SESSION *s, TIMEOUT_PARAM *p)
@@ -1055,8 +1140,9 @@ static void timeout_cb(SSL_SESSION *s, TIMEOUT_PARAM *p)
          * The reason we don't call SSL_CTX_remove_session() is to save on
          * locking overhead
          */
-        (void)lh_SSL_SESSION_delete(p->cache, s);
-        SSL_SESSION_list_remove(p->ctx, s);
+        (void)lh_SSL_SESSION_delete(p->shard->sessions, s);
+        SSL_SESSION_list_remove(p->shard, s);
+        ssl_session_cache_count(p->ctx, -1);
         s->not_resumable = 1;
         if (p->ctx->remove_session_cb != NULL)
             p->ctx->remove_session_cb(p->ctx, s);
@@ -1069,19 +1155,23 @@ IMPLEMENT_LHASH_DOALL_ARG(SSL_SESSION, TIMEOUT_PARAM);
 void SSL_CTX_flush_sessions(SSL_CTX *s, long t)
 {
     unsigned long i;
+    size_t n;
     TIMEOUT_PARAM tp;
 
     tp.ctx = s;
-    tp.cache = s->sessions;
-    if (tp.cache == NULL)
-        return;
     tp.time = t;
-    CRYPTO_THREAD_write_lock(s->lock);
-    i = lh_SSL_SESSION_get_down_load(s->sessions);
-    lh_SSL_SESSION_set_down_load(s->sessions, 0);
-    lh_SSL_SESSION_doall_TIMEOUT_PARAM(tp.cache, timeout_cb, &tp);
-    lh_SSL_SESSION_set_down_load(s->sessions, i);
-    CRYPTO_THREAD_unlock(s->lock);
+    for (n = 0; n < SSL_SESSION_CACHE_SHARDS; n++) {
+        tp.shard = &s->sessions[n];
+        /* SSL_CTX_new() may have failed before setting up every shard */
+        if (tp.shard->sessions == NULL || tp.shard->lock == NULL)
+            continue;
+        CRYPTO_THREAD_write_lock(tp.shard->lock);
+        i = lh_SSL_SESSION_get_down_load(tp.shard->sessions);
+        lh_SSL_SESSION_set_down_load(tp.shard->sessions, 0);
+        lh_SSL_SESSION_doall_TIMEOUT_PARAM(tp.shard->sessions, timeout_cb, &tp);
+        lh_SSL_SESSION_set_down_load(tp.shard->sessions, i);
+        CRYPTO_THREAD_unlock(tp.shard->lock);
+    }
 }
 
 int ssl_clear_bad_session(SSL *s)
@@ -1095,27 +1185,28 @@ int ssl_clear_bad_session(SSL *s)
         return 0;
 }
 
-/* locked by SSL_CTX in the calling function */
-static void SSL_SESSION_list_remove(SSL_CTX *ctx, SSL_SESSION *s)
+/* locked by the shard in the calling function */
+static void SSL_SESSION_list_remove(SSL_SESSION_CACHE_SHARD *shard,
+                                    SSL_SESSION *s)
 {
     if ((s->next == NULL) || (s->prev == NULL))
         return;
 
-    if (s->next == (SSL_SESSION *)&(ctx->session_cache_tail)) {
+    if (s->next == (SSL_SESSION *)&(shard->session_cache_tail)) {
         /* last element in list */
-        if (s->prev == (SSL_SESSION *)&(ctx->session_cache_head)) {
+        if (s->prev == (SSL_SESSION *)&(shard->session_cache_head)) {
             /* only one element in list */
-            ctx->session_cache_head = NULL;
-            ctx->session_cache_tail = NULL;
+            shard->session_cache_head = NULL;
+            shard->session_cache_tail = NULL;
         } else {
-            ctx->session_cache_tail = s->prev;
-            s->prev->next = (SSL_SESSION *)&(ctx->session_cache_tail);
+            shard->session_cache_tail = s->prev;
+            s->prev->next = (SSL_SESSION *)&(shard->session_cache_tail);
         }
     } else {
-        if (s->prev == (SSL_SESSION *)&(ctx->session_cache_head)) {
+        if (s->prev == (SSL_SESSION *)&(shard->session_cache_head)) {
             /* first element in list */
-            ctx->session_cache_head = s->next;
-            s->next->prev = (SSL_SESSION *)&(ctx->session_cache_head);
+            shard->session_cache_head = s->next;
+            s->next->prev = (SSL_SESSION *)&(shard->session_cache_head);
         } else {
             /* middle of list */
             s->next->prev = s->prev;
@@ -1125,21 +1216,22 @@ static void SSL_SESSION_list_remove(SSL_CTX *ctx, SSL_SESSION *s)
     s->prev = s->next = NULL;
 }
 
-static void SSL_SESSION_list_add(SSL_CTX *ctx, SSL_SESSION *s)
+static void SSL_SESSION_list_add(SSL_SESSION_CACHE_SHARD *shard,
+                                 SSL_SESSION *s)
 {
     if ((s->next != NULL) && (s->prev != NULL))
-        SSL_SESSION_list_remove(ctx, s);
+        SSL_SESSION_list_remove(shard, s);
 
-    if (ctx->session_cache_head == NULL) {
-        ctx->session_cache_head = s;
-        ctx->session_cache_tail = s;
-        s->prev = (SSL_SESSION *)&(ctx->session_cache_head);
-        s->next = (SSL_SESSION *)&(ctx->session_cache_tail);
+    if (shard->session_cache_head == NULL) {
+        shard->session_cache_head = s;
+        shard->session_cache_tail = s;
+        s->prev = (SSL_SESSION *)&(shard->session_cache_head);
+        s->next = (SSL_SESSION *)&(shard->session_cache_tail);
     } else {
-        s->next = ctx->session_cache_head;
+        s->next = shard->session_cache_head;
         s->next->prev = s;
-        s->prev = (SSL_SESSION *)&(ctx->session_cache_head);
-        ctx->session_cache_head = s;
+        s->prev = (SSL_SESSION *)&(shard->session_cache_head);
+        shard->session_cache_head = s;
     }
 }
 
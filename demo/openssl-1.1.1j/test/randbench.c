@@ -0,0 +1,163 @@
+/*
+ * Copyright 2021 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the OpenSSL license (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * Measures the throughput of small RAND_bytes() requests made concurrently
+ * by several threads, which is where contention on shared RAND state shows.
+ * It is not run by "make test":
+ *
+ *     randbench [threads [seconds [bytes]]]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#if defined(_WIN32)
+# include <windows.h>
+#endif
+
+#include <openssl/crypto.h>
+#include <openssl/rand.h>
+
+#define MAX_THREADS 256
+#define MAX_BYTES 4096
+
+static int seconds = 3;
+static int num_bytes = 16;
+
+typedef struct {
+    unsigned long calls;
+    int failed;
+} BENCH_RESULT;
+
+static BENCH_RESULT results[MAX_THREADS];
+
+static void run_bench(BENCH_RESULT *result)
+{
+    unsigned char buf[MAX_BYTES];
+    time_t start = time(NULL);
+
+    do {
+        int i;
+
+        for (i = 0; i < 1024; i++) {
+            if (RAND_bytes(buf, num_bytes) <= 0)
+                result->failed = 1;
+        }
+        result->calls += 1024;
+    } while (time(NULL) - start < seconds);
+}
+
+#if !defined(OPENSSL_THREADS)
+
+typedef BENCH_RESULT *thread_t;
+
+static int run_thread(thread_t *t, BENCH_RESULT *result)
+{
+    run_bench(result);
+    return 1;
+}
+
+static int wait_for_thread(thread_t thread)
+{
+    return 1;
+}
+
+#elif defined(OPENSSL_SYS_WINDOWS)
+
+typedef HANDLE thread_t;
+
+static DWORD WINAPI thread_run(LPVOID arg)
+{
+    run_bench(arg);
+    OPENSSL_thread_stop();
+    return 0;
+}
+
+static int run_thread(thread_t *t, BENCH_RESULT *result)
+{
+    *t = CreateThread(NULL, 0, thread_run, result, 0, NULL);
+    return *t != NULL;
+}
+
+static int wait_for_thread(thread_t thread)
+{
+    return WaitForSingleObject(thread, INFINITE) == 0;
+}
+
+#else
+
+# include <pthread.h>
+
+typedef pthread_t thread_t;
+
+static void *thread_run(void *arg)
+{
+    run_bench(arg);
+    OPENSSL_thread_stop();
+    return NULL;
+}
+
+static int run_thread(thread_t *t, BENCH_RESULT *result)
+{
+    return pthread_create(t, NULL, thread_run, result) == 0;
+}
+
+static int wait_for_thread(thread_t thread)
+{
+    return pthread_join(thread, NULL) == 0;
+}
+
+#endif
+
+int main(int argc, char *argv[])
+{
+    thread_t threads[MAX_THREADS];
+    unsigned long total = 0;
+    int num_threads = 4;
+    int i, ret = EXIT_SUCCESS;
+    unsigned char buf[1];
+
+    if (argc > 1)
+        num_threads = atoi(argv[1]);
+    if (argc > 2)
+        seconds = atoi(argv[2]);
+    if (argc > 3)
+        num_bytes = atoi(argv[3]);
+    if (num_threads < 1 || num_threads > MAX_THREADS || seconds < 1
+            || num_bytes < 1 || num_bytes > MAX_BYTES) {
+        fprintf(stderr, "usage: %s [threads [seconds [bytes]]]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    /* Instantiate the master DRBG before the threads start */
+    if (RAND_bytes(buf, sizeof(buf)) <= 0) {
+        fprintf(stderr, "RAND_bytes failed\n");
+        return EXIT_FAILURE;
+    }
+
+    for (i = 0; i < num_threads; i++) {
+        if (!run_thread(&threads[i], &results[i])) {
+            fprintf(stderr, "cannot start thread %d\n", i);
+            return EXIT_FAILURE;
+        }
+    }
+    for (i = 0; i < num_threads; i++) {
+        wait_for_thread(threads[i]);
+        total += results[i].calls;
+        if (results[i].failed)
+            ret = EXIT_FAILURE;
+    }
+
+    printf("%d threads, %d byte requests: %.0f calls/s, %.2f MB/s%s\n",
+           num_threads, num_bytes, (double)total / seconds,
+           (double)total * num_bytes / seconds / 1e6,
+           ret == EXIT_SUCCESS ? "" : " (RAND_bytes failed)");
+    return ret;
+}
@@ -793,6 +793,67 @@ static int test_large_message_tls_read_ahead(void)
                                       1);
 }
 
+/*
+ * Test that a large write in SSL_MODE_BATCH_WRITES mode, which sends several
+ * records with each BIO write, is received intact.
+ * Test 0: TLSv1.2
+ * Test 1: TLSv1.3
+ */
+static int test_batch_writes(int tst)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientssl = NULL, *serverssl = NULL;
+    int testresult = 0;
+    static unsigned char msg[SSL3_RT_MAX_PLAIN_LENGTH * 11 + 100];
+    unsigned char buf[SSL3_RT_MAX_PLAIN_LENGTH];
+    size_t i, written, readbytes, total = 0;
+    int tlsvers = (tst == 0) ? TLS1_2_VERSION : TLS1_3_VERSION;
+
+#ifdef OPENSSL_NO_TLS1_2
+    if (tst == 0)
+        return 1;
+#endif
+#ifdef OPENSSL_NO_TLS1_3
+    if (tst == 1)
+        return 1;
+#endif
+
+    for (i = 0; i < sizeof(msg); i++)
+        msg[i] = (unsigned char)(i % 251);
+
+    if (!TEST_true(create_ssl_ctx_pair(TLS_server_method(),
+                                       TLS_client_method(),
+                                       tlsvers, tlsvers, &sctx, &cctx, cert,
+                                       privkey))
+            || !TEST_true(create_ssl_objects(sctx, cctx, &serverssl,
+                                             &clientssl, NULL, NULL))
+            || !TEST_true(create_ssl_connection(serverssl, clientssl,
+                                                SSL_ERROR_NONE)))
+        goto end;
+
+    SSL_set_mode(clientssl, SSL_MODE_BATCH_WRITES);
+    if (!TEST_true(SSL_write_ex(clientssl, msg, sizeof(msg), &written))
+            || !TEST_size_t_eq(written, sizeof(msg)))
+        goto end;
+
+    while (total < sizeof(msg)) {
+        if (!TEST_true(SSL_read_ex(serverssl, buf, sizeof(buf), &readbytes))
+                || !TEST_size_t_le(total + readbytes, sizeof(msg))
+                || !TEST_mem_eq(buf, readbytes, msg + total, readbytes))
+            goto end;
+        total += readbytes;
+    }
+
+    testresult = 1;
+ end:
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+
 #ifndef OPENSSL_NO_DTLS
 static int test_large_message_dtls(void)
 {
@@ -1340,6 +1401,136 @@ static int test_session_with_both_cache(void)
 #endif
 }
 
+/*
+ * Test that sessions spread over the shards of the internal cache can all be
+ * found again, and that a bounded cache stays within its size.
+ */
+static int test_session_cache_shards(void)
+{
+    SSL_CTX *ctx = NULL;
+    SSL_SESSION *sess[200];
+    unsigned char id[SSL_MAX_SSL_SESSION_ID_LENGTH];
+    size_t i;
+    int testresult = 0;
+
+    memset(sess, 0, sizeof(sess));
+    if (!TEST_ptr(ctx = SSL_CTX_new(TLS_server_method())))
+        goto end;
+    SSL_CTX_sess_set_cache_size(ctx, 0);
+
+    for (i = 0; i < OSSL_NELEM(sess); i++) {
+        memset(id, 0, sizeof(id));
+        id[0] = (unsigned char)i;
+        id[sizeof(id) - 1] = (unsigned char)(i * 7);
+        if (!TEST_ptr(sess[i] = SSL_SESSION_new())
+                || !TEST_true(SSL_SESSION_set1_id(sess[i], id, sizeof(id)))
+                || !TEST_true(SSL_CTX_add_session(ctx, sess[i])))
+            goto end;
+    }
+    if (!TEST_long_eq(SSL_CTX_sess_number(ctx), (long)OSSL_NELEM(sess))
+            || !TEST_false(SSL_CTX_add_session(ctx, sess[0])))
+        goto end;
+#if SSL_SESSION_CACHE_SHARDS == 1
+    /* Without sharding SSL_CTX_sessions() is the live table of the cache */
+    if (!TEST_ptr(SSL_CTX_sessions(ctx))
+            || !TEST_ulong_eq(lh_SSL_SESSION_num_items(SSL_CTX_sessions(ctx)),
+                              OSSL_NELEM(sess)))
+        goto end;
+#endif
+
+    for (i = 0; i < OSSL_NELEM(sess); i++) {
+        if (!TEST_true(SSL_CTX_remove_session(ctx, sess[i])))
+            goto end;
+    }
+    if (!TEST_long_eq(SSL_CTX_sess_number(ctx), 0))
+        goto end;
+
+    SSL_CTX_sess_set_cache_size(ctx, 64);
+    for (i = 0; i < OSSL_NELEM(sess); i++) {
+        if (!TEST_true(SSL_CTX_add_session(ctx, sess[i])))
+            goto end;
+    }
+    if (!TEST_long_eq(SSL_CTX_sess_number(ctx), 64))
+        goto end;
+
+    testresult = 1;
+
+ end:
+    for (i = 0; i < OSSL_NELEM(sess); i++)
+        SSL_SESSION_free(sess[i]);
+    SSL_CTX_free(ctx);
+
+    return testresult;
+}
+
+/*
+ * Test that the cache size bounds the number of sessions over all shards,
+ * including sizes smaller than the number of shards (idx == 0) and session
+ * IDs too short to be spread over the shards (idx == 1). A new session is
+ * never the one evicted, and within one shard the oldest sessions go first.
+ */
+static int test_session_cache_size(int idx)
+{
+    SSL_CTX *ctx = NULL;
+    SSL_SESSION *sess[40];
+    unsigned char id[SSL_MAX_SSL_SESSION_ID_LENGTH];
+    size_t idlen = idx == 0 ? sizeof(id) : 4;
+    long size = idx == 0 ? 5 : 24;
+    long removed = 0;
+    size_t i;
+    int testresult = 0;
+
+    memset(sess, 0, sizeof(sess));
+    if (!TEST_ptr(ctx = SSL_CTX_new(TLS_server_method())))
+        goto end;
+    SSL_CTX_sess_set_cache_size(ctx, size);
+
+    for (i = 0; i < OSSL_NELEM(sess); i++) {
+        memset(id, 0, sizeof(id));
+        id[0] = (unsigned char)i;
+        id[idlen - 1] = (unsigned char)(i * 7);
+        if (!TEST_ptr(sess[i] = SSL_SESSION_new())
+                || !TEST_true(SSL_SESSION_set1_id(sess[i], id, idlen))
+                || !TEST_true(SSL_CTX_add_session(ctx, sess[i]))
+                || !TEST_long_le(SSL_CTX_sess_number(ctx), size))
+            goto end;
+    }
+    if (!TEST_long_eq(SSL_CTX_sess_number(ctx), size))
+        goto end;
+#if SSL_SESSION_CACHE_SHARDS == 1
+    if (!TEST_ptr(SSL_CTX_sessions(ctx))
+            || !TEST_ulong_eq(lh_SSL_SESSION_num_items(SSL_CTX_sessions(ctx)),
+                              (unsigned long)size))
+        goto end;
+#endif
+
+    for (i = 0; i < OSSL_NELEM(sess); i++) {
+        int cached = SSL_CTX_remove_session(ctx, sess[i]);
+
+        /*
+         * The last session added is always kept. All the short IDs share a
+         * shard, so there exactly the newest ones are kept.
+         */
+        if ((idx == 1 || i == OSSL_NELEM(sess) - 1)
+                && !TEST_int_eq(cached,
+                                i >= OSSL_NELEM(sess) - (size_t)size))
+            goto end;
+        removed += cached;
+    }
+    if (!TEST_long_eq(removed, size)
+            || !TEST_long_eq(SSL_CTX_sess_number(ctx), 0))
+        goto end;
+
+    testresult = 1;
+
+ end:
+    for (i = 0; i < OSSL_NELEM(sess); i++)
+        SSL_SESSION_free(sess[i]);
+    SSL_CTX_free(ctx);
+
+    return testresult;
+}
+
 #ifndef OPENSSL_NO_TLS1_3
 static SSL_SESSION *sesscache[6];
 static int do_cache;
@@ -6749,6 +6940,7 @@ int setup_tests(void)
 
     ADD_TEST(test_large_message_tls);
     ADD_TEST(test_large_message_tls_read_ahead);
+    ADD_ALL_TESTS(test_batch_writes, 2);
 #ifndef OPENSSL_NO_DTLS
     ADD_TEST(test_large_message_dtls);
 #endif
@@ -6758,6 +6950,8 @@ int setup_tests(void)
     ADD_TEST(test_session_with_only_int_cache);
     ADD_TEST(test_session_with_only_ext_cache);
     ADD_TEST(test_session_with_both_cache);
+    ADD_TEST(test_session_cache_shards);
+    ADD_ALL_TESTS(test_session_cache_size, 2);
 #ifndef OPENSSL_NO_TLS1_3
     ADD_ALL_TESTS(test_stateful_tickets, 3);
     ADD_ALL_TESTS(test_stateless_tickets, 3);
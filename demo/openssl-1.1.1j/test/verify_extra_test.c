@@ -15,6 +15,11 @@
 #include <openssl/err.h>
 #include "testutil.h"
 
+#if !defined(OPENSSL_NO_POSIX_IO) && !defined(_WIN32)
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
 static const char *roots_f;
 static const char *untrusted_f;
 static const char *bad_f;
@@ -219,6 +224,115 @@ static int test_self_signed_bad(void)
     return test_self_signed(bad_f, 0);
 }
 
+/*
+ * Verify the same chain repeatedly through a store with a chain cache, so that
+ * the later verifications skip the signature checks.
+ */
+static int test_chain_cache(void)
+{
+    X509 *cert = load_cert_pem(good_f);
+    X509_STORE *store = X509_STORE_new();
+    X509_STORE_CTX *ctx = X509_STORE_CTX_new();
+    int i, ret;
+
+    ret = TEST_ptr(cert)
+        && TEST_ptr(store)
+        && TEST_ptr(ctx)
+        && TEST_true(X509_STORE_add_cert(store, cert))
+        && TEST_true(X509_STORE_set_flags(store,
+                                          X509_V_FLAG_CHECK_SS_SIGNATURE))
+        && TEST_true(X509_STORE_set_chain_cache_size(store, 16))
+        && TEST_int_eq(X509_STORE_get_chain_cache_size(store), 16);
+
+    for (i = 0; ret && i < 3; i++) {
+        ret = TEST_true(X509_STORE_CTX_init(ctx, store, cert, NULL))
+            && TEST_int_eq(X509_verify_cert(ctx), 1)
+            && TEST_int_eq(X509_STORE_CTX_get_error(ctx), X509_V_OK);
+        X509_STORE_CTX_cleanup(ctx);
+    }
+
+    /* Switching the cache off must not change the result */
+    ret = ret
+        && TEST_true(X509_STORE_set_chain_cache_size(store, 0))
+        && TEST_true(X509_STORE_CTX_init(ctx, store, cert, NULL))
+        && TEST_int_eq(X509_verify_cert(ctx), 1);
+
+    X509_STORE_CTX_free(ctx);
+    X509_STORE_free(store);
+    X509_free(cert);
+    return ret;
+}
+
+#if !defined(OPENSSL_NO_POSIX_IO) && !defined(_WIN32)
+/*
+ * Look up more names than a hashed directory remembers before the one
+ * certificate that is actually in it, so that the directory's hash index is
+ * grown, capped and searched again.
+ */
+static int test_hash_dir(void)
+{
+    static const char dir[] = "verify_extra_test_dir";
+    char path[sizeof(dir) + 1 + 8 + 2 + 1];
+    X509 *cert = load_cert_pem(good_f);
+    X509_STORE *store = X509_STORE_new();
+    X509_STORE_CTX *ctx = X509_STORE_CTX_new();
+    X509_LOOKUP *lookup;
+    X509_NAME *name = NULL;
+    X509_OBJECT *obj = NULL;
+    BIO *bio = NULL;
+    char cn[32];
+    int i, ret;
+
+    ret = TEST_ptr(cert)
+        && TEST_ptr(store)
+        && TEST_ptr(ctx)
+        && TEST_int_eq(mkdir(dir, 0700), 0);
+    if (!ret)
+        goto err;
+
+    BIO_snprintf(path, sizeof(path), "%s/%08lx.0", dir,
+                 X509_subject_name_hash(cert));
+    ret = TEST_ptr(bio = BIO_new_file(path, "w"))
+        && TEST_true(PEM_write_bio_X509(bio, cert));
+    BIO_free(bio);
+
+    ret = ret
+        && TEST_ptr(lookup = X509_STORE_add_lookup(store,
+                                                   X509_LOOKUP_hash_dir()))
+        && TEST_true(X509_LOOKUP_add_dir(lookup, dir, X509_FILETYPE_PEM))
+        && TEST_true(X509_STORE_CTX_init(ctx, store, NULL, NULL));
+
+    for (i = 0; ret && i < 1100; i++) {
+        BIO_snprintf(cn, sizeof(cn), "missing %d", i);
+        X509_NAME_free(name);
+        ret = TEST_ptr(name = X509_NAME_new())
+            && TEST_true(X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                                                    (unsigned char *)cn, -1,
+                                                    -1, 0))
+            && TEST_ptr_null(X509_STORE_CTX_get_obj_by_subject(ctx,
+                                                               X509_LU_X509,
+                                                               name));
+    }
+
+    for (i = 0; ret && i < 2; i++) {
+        ret = TEST_ptr(obj = X509_STORE_CTX_get_obj_by_subject(ctx,
+                                        X509_LU_X509,
+                                        X509_get_subject_name(cert)))
+            && TEST_int_eq(X509_cmp(X509_OBJECT_get0_X509(obj), cert), 0);
+        X509_OBJECT_free(obj);
+    }
+
+    unlink(path);
+    rmdir(dir);
+ err:
+    X509_NAME_free(name);
+    X509_STORE_CTX_free(ctx);
+    X509_STORE_free(store);
+    X509_free(cert);
+    return ret;
+}
+#endif
+
 int setup_tests(void)
 {
     if (!TEST_ptr(roots_f = test_get_argument(0))
@@ -233,5 +347,9 @@ int setup_tests(void)
     ADD_TEST(test_store_ctx);
     ADD_TEST(test_self_signed_good);
     ADD_TEST(test_self_signed_bad);
+    ADD_TEST(test_chain_cache);
+#if !defined(OPENSSL_NO_POSIX_IO) && !defined(_WIN32)
+    ADD_TEST(test_hash_dir);
+#endif
     return 1;
 }
@@ -161,34 +161,29 @@ void FBXImporter::InternReadFile( const std::string& pFile,
 
     // broadphase tokenizing pass in which we identify the core
     // syntax elements of FBX (brackets, commas, key:value mappings)
+    // the arena owns the tokens, and frees them all at once on return or
+    // on exception
     TokenList tokens;
-    try {
+    TokenArena arena;
 
-        bool is_binary = false;
-        if (!strncmp(begin,"Kaydara FBX Binary",18)) {
-            is_binary = true;
-            TokenizeBinary(tokens,begin,static_cast<unsigned int>(contents.size()));
-        }
-        else {
-            Tokenize(tokens,begin);
-        }
-
-        // use this information to construct a very rudimentary
-        // parse-tree representing the FBX scope structure
-        Parser parser(tokens, is_binary);
+    bool is_binary = false;
+    if (!strncmp(begin,"Kaydara FBX Binary",18)) {
+        is_binary = true;
+        TokenizeBinary(tokens,begin,static_cast<unsigned int>(contents.size()),arena);
+    }
+    else {
+        Tokenize(tokens,begin,arena);
+    }
 
-        // take the raw parse-tree and convert it to a FBX DOM
-        Document doc(parser,settings);
+    // use this information to construct a very rudimentary
+    // parse-tree representing the FBX scope structure
+    Parser parser(tokens, is_binary);
 
-        // convert the FBX DOM to aiScene
-        ConvertToAssimpScene(pScene,doc);
+    // take the raw parse-tree and convert it to a FBX DOM
+    Document doc(parser,settings);
 
-        std::for_each(tokens.begin(),tokens.end(),Util::delete_fun<Token>());
-    }
-    catch(std::exception&) {
-        std::for_each(tokens.begin(),tokens.end(),Util::delete_fun<Token>());
-        throw;
-    }
+    // convert the FBX DOM to aiScene
+    ConvertToAssimpScene(pScene,doc);
 }
 
 #endif // !ASSIMP_BUILD_NO_FBX_IMPORTER
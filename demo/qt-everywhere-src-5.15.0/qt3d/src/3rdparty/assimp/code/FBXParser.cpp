@@ -61,6 +61,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ByteSwapper.h"
 
 #include <iostream>
+#include <limits>
 
 using namespace Assimp;
 using namespace Assimp::FBX;
@@ -517,24 +518,11 @@ void ReadBinaryDataArrayHead(const char*& data, const char* end, char& type, uin
 
 
 // ------------------------------------------------------------------------------------------------
-// read binary data array, assume cursor points to the 'compression mode' field (i.e. behind the header)
-void ReadBinaryDataArray(char type, uint32_t count, const char*& data, const char* end,
-    std::vector<char>& buff,
-    const Element& /*el*/)
+// number of bytes taken by 'count' elements of 'type' once uncompressed, computed in 64 bits so
+// that a crafted element count cannot wrap it around.
+size_t BinaryDataArrayLength(char type, uint32_t count, const Element& el)
 {
-    BE_NCONST uint32_t encmode = SafeParse<uint32_t>(data, end);
-    AI_SWAP4(encmode);
-    data += 4;
-
-    // next comes the compressed length
-    BE_NCONST uint32_t comp_len = SafeParse<uint32_t>(data, end);
-    AI_SWAP4(comp_len);
-    data += 4;
-
-    ai_assert(data + comp_len == end);
-
-    // determine the length of the uncompressed data by looking at the type signature
-    uint32_t stride = 0;
+    uint64_t stride = 0;
     switch(type)
     {
     case 'f':
@@ -551,14 +539,39 @@ void ReadBinaryDataArray(char type, uint32_t count, const char*& data, const cha
         ai_assert(false);
     };
 
-    const uint32_t full_length = stride * count;
-    buff.resize(full_length);
+    const uint64_t length = stride * count;
+    if (length > std::numeric_limits<uInt>::max() || length > std::numeric_limits<size_t>::max()) {
+        ParseError("binary data array is too large",&el);
+    }
+    return static_cast<size_t>(length);
+}
+
+// ------------------------------------------------------------------------------------------------
+// read binary data array, assume cursor points to the 'compression mode' field (i.e. behind the header).
+// 'out' receives the uncompressed data, 'full_length' bytes as computed by BinaryDataArrayLength().
+void ReadBinaryDataArray(const char*& data, const char* end,
+    char* out, size_t full_length,
+    const Element& el)
+{
+    BE_NCONST uint32_t encmode = SafeParse<uint32_t>(data, end);
+    AI_SWAP4(encmode);
+    data += 4;
+
+    // next comes the compressed length
+    BE_NCONST uint32_t comp_len = SafeParse<uint32_t>(data, end);
+    AI_SWAP4(comp_len);
+    data += 4;
+
+    ai_assert(data + comp_len == end);
 
     if(encmode == 0) {
-        ai_assert(full_length == comp_len);
+        // 'out' is sized after the element count, never write past it
+        if (full_length != comp_len || static_cast<size_t>(end - data) < comp_len) {
+            ParseError("length of uncompressed binary data array does not match its element count",&el);
+        }
 
         // plain data, no compression
-        std::copy(data, end, buff.begin());
+        std::copy(data, data + comp_len, out);
     }
     else if(encmode == 1) {
         // zlib/deflate, next comes ZIP head (0x78 0x01)
@@ -578,8 +591,8 @@ void ReadBinaryDataArray(char type, uint32_t count, const char*& data, const cha
         zstream.next_in   = reinterpret_cast<Bytef*>( const_cast<char*>(data) );
         zstream.avail_in  = comp_len;
 
-        zstream.avail_out = static_cast<uInt>(buff.size());
-        zstream.next_out = reinterpret_cast<Bytef*>(&*buff.begin());
+        zstream.avail_out = static_cast<uInt>(full_length);
+        zstream.next_out = reinterpret_cast<Bytef*>(out);
         const int ret = inflate(&zstream, Z_FINISH);
 
         if (ret != Z_STREAM_END && ret != Z_OK) {
@@ -600,6 +613,36 @@ void ReadBinaryDataArray(char type, uint32_t count, const char*& data, const cha
     ai_assert(data == end);
 }
 
+
+
+// ------------------------------------------------------------------------------------------------
+// read binary data array into a temporary buffer, for arrays which need converting
+void ReadBinaryDataArray(char type, uint32_t count, const char*& data, const char* end,
+    std::vector<char>& buff,
+    const Element& el)
+{
+    const size_t full_length = BinaryDataArrayLength(type, count, el);
+    buff.resize(full_length);
+    ReadBinaryDataArray(data, end, buff.empty() ? NULL : &buff[0], full_length, el);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// read binary data array straight into 'out' when its elements are made of
+// 'count' values of the array type, saving a temporary copy of the data.
+template <typename T>
+void ReadBinaryDataArrayDirect(char type, uint32_t count, const char*& data, const char* end,
+    std::vector<T>& out,
+    const Element& el)
+{
+    const size_t full_length = BinaryDataArrayLength(type, count, el);
+    if (full_length % sizeof(T) != 0) {
+        ParseError("binary data array does not hold a whole number of elements",&el);
+    }
+    out.resize(full_length / sizeof(T));
+    ReadBinaryDataArray(data, end, out.empty() ? NULL : reinterpret_cast<char*>(&out[0]), full_length, el);
+}
+
 } // !anon
 
 
@@ -633,6 +676,13 @@ void ParseVectorDataArray(std::vector<aiVector3D>& out, const Element& el)
             ParseError("expected float or double array (binary)",&el);
         }
 
+        if (type == 'f' && sizeof(aiVector3D) == 3 * sizeof(float)) {
+            // same layout as the output, inflate straight into it
+            ReadBinaryDataArrayDirect(type, count, data, end, out, el);
+            ai_assert(data == end);
+            return;
+        }
+
         std::vector<char> buff;
         ReadBinaryDataArray(type, count, data, end, buff, el);
 
@@ -720,6 +770,13 @@ void ParseVectorDataArray(std::vector<aiColor4D>& out, const Element& el)
             ParseError("expected float or double array (binary)",&el);
         }
 
+        if (type == 'f' && sizeof(aiColor4D) == 4 * sizeof(float)) {
+            // same layout as the output, inflate straight into it
+            ReadBinaryDataArrayDirect(type, count, data, end, out, el);
+            ai_assert(data == end);
+            return;
+        }
+
         std::vector<char> buff;
         ReadBinaryDataArray(type, count, data, end, buff, el);
 
@@ -799,6 +856,13 @@ void ParseVectorDataArray(std::vector<aiVector2D>& out, const Element& el)
             ParseError("expected float or double array (binary)",&el);
         }
 
+        if (type == 'f' && sizeof(aiVector2D) == 2 * sizeof(float)) {
+            // same layout as the output, inflate straight into it
+            ReadBinaryDataArrayDirect(type, count, data, end, out, el);
+            ai_assert(data == end);
+            return;
+        }
+
         std::vector<char> buff;
         ReadBinaryDataArray(type, count, data, end, buff, el);
 
@@ -871,19 +935,11 @@ void ParseVectorDataArray(std::vector<int>& out, const Element& el)
             ParseError("expected int array (binary)",&el);
         }
 
-        std::vector<char> buff;
-        ReadBinaryDataArray(type, count, data, end, buff, el);
-
+        ReadBinaryDataArrayDirect(type, count, data, end, out, el);
         ai_assert(data == end);
-        ai_assert(buff.size() == count * 4);
-
-        out.reserve(count);
 
-        const int32_t* ip = reinterpret_cast<const int32_t*>(&buff[0]);
-        for (unsigned int i = 0; i < count; ++i, ++ip) {
-            BE_NCONST int32_t val = *ip;
-            AI_SWAP4(val);
-            out.push_back(val);
+        for (std::vector<int>::iterator it = out.begin(); it != out.end(); ++it) {
+            AI_SWAP4(*it);
         }
 
         return;
@@ -929,6 +985,12 @@ void ParseVectorDataArray(std::vector<float>& out, const Element& el)
             ParseError("expected float or double array (binary)",&el);
         }
 
+        if (type == 'f') {
+            ReadBinaryDataArrayDirect(type, count, data, end, out, el);
+            ai_assert(data == end);
+            return;
+        }
+
         std::vector<char> buff;
         ReadBinaryDataArray(type, count, data, end, buff, el);
 
@@ -941,12 +1003,6 @@ void ParseVectorDataArray(std::vector<float>& out, const Element& el)
                 out.push_back(static_cast<float>(*d));
             }
         }
-        else if (type == 'f') {
-            const float* f = reinterpret_cast<const float*>(&buff[0]);
-            for (unsigned int i = 0; i < count; ++i, ++f) {
-                out.push_back(*f);
-            }
-        }
 
         return;
     }
@@ -1114,19 +1170,11 @@ void ParseVectorDataArray(std::vector<int64_t>& out, const Element& el)
             ParseError("expected long array (binary)", &el);
         }
 
-        std::vector<char> buff;
-        ReadBinaryDataArray(type, count, data, end, buff, el);
-
+        ReadBinaryDataArrayDirect(type, count, data, end, out, el);
         ai_assert(data == end);
-        ai_assert(buff.size() == count * 8);
 
-        out.reserve(count);
-
-        const int64_t* ip = reinterpret_cast<const int64_t*>(&buff[0]);
-        for (unsigned int i = 0; i < count; ++i, ++ip) {
-            BE_NCONST int64_t val = *ip;
-            AI_SWAP8(val);
-            out.push_back(val);
+        for (std::vector<int64_t>::iterator it = out.begin(); it != out.end(); ++it) {
+            AI_SWAP8(*it);
         }
 
         return;
@@ -54,6 +54,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "FBXUtil.h"
 #include "Exceptional.h"
 
+#include <new>
+
 namespace Assimp {
 namespace FBX {
 
@@ -83,6 +85,60 @@ Token::~Token()
 }
 
 
+// ------------------------------------------------------------------------------------------------
+TokenArena::TokenArena()
+    : used(BLOCK_SIZE)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+TokenArena::~TokenArena()
+{
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        const size_t count = (i + 1 == blocks.size() ? used : BLOCK_SIZE);
+        for (size_t j = 0; j < count; ++j) {
+            blocks[i][j].~Token();
+        }
+        ::operator delete(blocks[i]);
+    }
+}
+
+
+// ------------------------------------------------------------------------------------------------
+void* TokenArena::Allocate()
+{
+    if (used == BLOCK_SIZE) {
+        // make room first, so that the new block can't leak
+        if (blocks.size() == blocks.capacity()) {
+            blocks.reserve(blocks.size() * 2 + 16);
+        }
+        blocks.push_back(static_cast<Token*>(::operator new(BLOCK_SIZE * sizeof(Token))));
+        used = 0;
+    }
+    return blocks.back() + used;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+TokenPtr TokenArena::Create(const char* sbegin, const char* send, TokenType type, unsigned int line, unsigned int column)
+{
+    // only count the token once its constructor succeeded
+    Token* const t = new (Allocate()) Token(sbegin, send, type, line, column);
+    ++used;
+    return t;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+TokenPtr TokenArena::Create(const char* sbegin, const char* send, TokenType type, unsigned int offset)
+{
+    Token* const t = new (Allocate()) Token(sbegin, send, type, offset);
+    ++used;
+    return t;
+}
+
+
 namespace {
 
 // ------------------------------------------------------------------------------------------------
@@ -96,7 +152,7 @@ AI_WONT_RETURN void TokenizeError(const std::string& message, unsigned int line,
 
 // process a potential data token up to 'cur', adding it to 'output_tokens'.
 // ------------------------------------------------------------------------------------------------
-void ProcessDataToken( TokenList& output_tokens, const char*& start, const char*& end,
+void ProcessDataToken( TokenList& output_tokens, TokenArena& arena, const char*& start, const char*& end,
                       unsigned int line,
                       unsigned int column,
                       TokenType type = TokenType_DATA,
@@ -121,7 +177,7 @@ void ProcessDataToken( TokenList& output_tokens, const char*& start, const char*
             TokenizeError("non-terminated double quotes", line, column);
         }
 
-        output_tokens.push_back(new_Token(start,end + 1,type,line,column));
+        output_tokens.push_back(arena.Create(start,end + 1,type,line,column));
     }
     else if (must_have_token) {
         TokenizeError("unexpected character, expected data token", line, column);
@@ -133,7 +189,7 @@ void ProcessDataToken( TokenList& output_tokens, const char*& start, const char*
 }
 
 // ------------------------------------------------------------------------------------------------
-void Tokenize(TokenList& output_tokens, const char* input)
+void Tokenize(TokenList& output_tokens, const char* input, TokenArena& arena)
 {
     ai_assert(input);
 
@@ -165,7 +221,7 @@ void Tokenize(TokenList& output_tokens, const char* input)
                 in_double_quotes = false;
                 token_end = cur;
 
-                ProcessDataToken(output_tokens,token_begin,token_end,line,column);
+                ProcessDataToken(output_tokens,arena,token_begin,token_end,line,column);
                 pending_data_token = false;
             }
             continue;
@@ -182,30 +238,30 @@ void Tokenize(TokenList& output_tokens, const char* input)
             continue;
 
         case ';':
-            ProcessDataToken(output_tokens,token_begin,token_end,line,column);
+            ProcessDataToken(output_tokens,arena,token_begin,token_end,line,column);
             comment = true;
             continue;
 
         case '{':
-            ProcessDataToken(output_tokens,token_begin,token_end, line, column);
-            output_tokens.push_back(new_Token(cur,cur+1,TokenType_OPEN_BRACKET,line,column));
+            ProcessDataToken(output_tokens,arena,token_begin,token_end, line, column);
+            output_tokens.push_back(arena.Create(cur,cur+1,TokenType_OPEN_BRACKET,line,column));
             continue;
 
         case '}':
-            ProcessDataToken(output_tokens,token_begin,token_end,line,column);
-            output_tokens.push_back(new_Token(cur,cur+1,TokenType_CLOSE_BRACKET,line,column));
+            ProcessDataToken(output_tokens,arena,token_begin,token_end,line,column);
+            output_tokens.push_back(arena.Create(cur,cur+1,TokenType_CLOSE_BRACKET,line,column));
             continue;
 
         case ',':
             if (pending_data_token) {
-                ProcessDataToken(output_tokens,token_begin,token_end,line,column,TokenType_DATA,true);
+                ProcessDataToken(output_tokens,arena,token_begin,token_end,line,column,TokenType_DATA,true);
             }
-            output_tokens.push_back(new_Token(cur,cur+1,TokenType_COMMA,line,column));
+            output_tokens.push_back(arena.Create(cur,cur+1,TokenType_COMMA,line,column));
             continue;
 
         case ':':
             if (pending_data_token) {
-                ProcessDataToken(output_tokens,token_begin,token_end,line,column,TokenType_KEY,true);
+                ProcessDataToken(output_tokens,arena,token_begin,token_end,line,column,TokenType_KEY,true);
             }
             else {
                 TokenizeError("unexpected colon", line, column);
@@ -227,7 +283,7 @@ void Tokenize(TokenList& output_tokens, const char* input)
                     }
                 }
 
-                ProcessDataToken(output_tokens,token_begin,token_end,line,column,type);
+                ProcessDataToken(output_tokens,arena,token_begin,token_end,line,column,type);
             }
 
             pending_data_token = false;
@@ -156,7 +156,35 @@ private:
 typedef const Token* TokenPtr;
 typedef std::vector< TokenPtr > TokenList;
 
-#define new_Token new Token
+/** Owns the tokens of a file. Tokens are allocated in large blocks rather than
+ *  one by one, since large files contain millions of them, and are all
+ *  destroyed together with the arena. */
+class TokenArena
+{
+public:
+    TokenArena();
+    ~TokenArena();
+
+public:
+    /** construct a textual token */
+    TokenPtr Create(const char* sbegin, const char* send, TokenType type, unsigned int line, unsigned int column);
+
+    /** construct a binary token */
+    TokenPtr Create(const char* sbegin, const char* send, TokenType type, unsigned int offset);
+
+private:
+    TokenArena(const TokenArena&);
+    TokenArena& operator=(const TokenArena&);
+
+    void* Allocate();
+
+private:
+    static const size_t BLOCK_SIZE = 4096;
+
+    std::vector<Token*> blocks;
+    // number of tokens constructed in the last block
+    size_t used;
+};
 
 
 /** Main FBX tokenizer function. Transform input buffer into a list of preprocessed tokens.
@@ -165,8 +193,9 @@ typedef std::vector< TokenPtr > TokenList;
  *
  * @param output_tokens Receives a list of all tokens in the input data.
  * @param input_buffer Textual input buffer to be processed, 0-terminated.
+ * @param arena Allocates the tokens, which remain valid as long as it does.
  * @throw DeadlyImportError if something goes wrong */
-void Tokenize(TokenList& output_tokens, const char* input);
+void Tokenize(TokenList& output_tokens, const char* input, TokenArena& arena);
 
 
 /** Tokenizer function for binary FBX files.
@@ -176,8 +205,9 @@ void Tokenize(TokenList& output_tokens, const char* input);
  * @param output_tokens Receives a list of all tokens in the input data.
  * @param input_buffer Binary input buffer to be processed.
  * @param length Length of input buffer, in bytes. There is no 0-terminal.
+ * @param arena Allocates the tokens, which remain valid as long as it does.
  * @throw DeadlyImportError if something goes wrong */
-void TokenizeBinary(TokenList& output_tokens, const char* input, unsigned int length);
+void TokenizeBinary(TokenList& output_tokens, const char* input, unsigned int length, TokenArena& arena);
 
 
 } // ! FBX
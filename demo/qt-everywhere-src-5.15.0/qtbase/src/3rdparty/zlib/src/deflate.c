@@ -100,6 +100,17 @@ local  void check_match OF((deflate_state *s, IPos start, IPos match,
                             int length));
 #endif
 
+/* Extend matches in longest_match() a word at a time rather than a byte at a
+ * time. The match lengths found are the same, and so is the compressed
+ * output. Define NO_WIDE_MATCH to use the byte-at-a-time loop.
+ */
+#if !defined(UNALIGNED_OK) && !defined(NO_WIDE_MATCH) && \
+    defined(__GNUC__) && defined(__BYTE_ORDER__) && \
+    (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ || \
+     __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#  define WIDE_MATCH
+#endif
+
 /* ===========================================================================
  * Local data
  */
@@ -1341,6 +1352,30 @@ local uInt longest_match(s, cur_match)
         scan += 2, match++;
         Assert(*scan == *match, "match[2]?");
 
+#ifdef WIDE_MATCH
+        /* Compare sizeof(ulg) bytes at a time at strstart+3, ... Since
+         * sizeof(ulg) divides 256, the last compare ends at strstart+258,
+         * where the byte-at-a-time loop below stops as well.
+         */
+        scan++, match++;
+        do {
+            ulg scan_word, match_word, diff;
+
+            zmemcpy((Bytef *)&scan_word, scan, sizeof(ulg));
+            zmemcpy((Bytef *)&match_word, match, sizeof(ulg));
+            diff = scan_word ^ match_word;
+            if (diff != 0) {
+#  if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+                scan += __builtin_ctzl(diff) >> 3;
+#  else
+                scan += __builtin_clzl(diff) >> 3;
+#  endif
+                break;
+            }
+            scan += sizeof(ulg), match += sizeof(ulg);
+        } while (scan < strend);
+        if (scan > strend) scan = strend;
+#else
         /* We check for insufficient lookahead only every 8th comparison;
          * the 256th check will be made at strstart+258.
          */
@@ -1350,6 +1385,7 @@ local uInt longest_match(s, cur_match)
                  *++scan == *++match && *++scan == *++match &&
                  *++scan == *++match && *++scan == *++match &&
                  scan < strend);
+#endif /* WIDE_MATCH */
 
         Assert(scan <= s->window+(unsigned)(s->window_size-1), "wild scan");
 
@@ -12,6 +12,63 @@
 #  pragma message("Assembler code may have bugs -- use at your own risk")
 #else
 
+/* With INFLATE_FAST_WIDE, inflate_fast() refills the bit buffer up to eight
+   bytes at a time and copies matches from the output INFLATE_CHUNK bytes at a
+   time. Define NO_INFLATE_FAST_WIDE to use the byte-at-a-time code. */
+#if !defined(NO_INFLATE_FAST_WIDE) && defined(HAVE_MEMCPY) && \
+    defined(__GNUC__) && defined(__BYTE_ORDER__) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ && \
+    defined(__SIZEOF_LONG__) && __SIZEOF_LONG__ == 8
+#  define INFLATE_FAST_WIDE
+#  define INFLATE_CHUNK 8
+#endif
+
+#ifdef INFLATE_FAST_WIDE
+/*
+   Copy len bytes to out from dist bytes back in the output, and return the
+   new output position. Up to INFLATE_CHUNK - 1 bytes past the copy may be
+   written, so there must be len + INFLATE_CHUNK bytes of room at out.
+
+   When dist is less than INFLATE_CHUNK, the first bytes are copied one at a
+   time until the match repeats with a period of at least INFLATE_CHUNK, so
+   that no chunk reads bytes that it writes itself.
+ */
+local unsigned char FAR *chunk_copy OF((unsigned char FAR *out,
+                                        unsigned dist, unsigned len));
+local unsigned char FAR *chunk_copy(out, dist, len)
+unsigned char FAR *out;
+unsigned dist;
+unsigned len;
+{
+    unsigned char FAR *from = out - dist;
+    unsigned char FAR *stop = out + len;
+    unsigned period;
+
+    if (dist < INFLATE_CHUNK) {
+        period = dist;
+        while (period < INFLATE_CHUNK)
+            period += dist;
+        if (period - dist >= len) {
+            do {
+                *out++ = *from++;
+            } while (--len);
+            return stop;
+        }
+        len = period - dist;
+        do {
+            *out++ = *from++;
+        } while (--len);
+        from = out - period;
+    }
+    do {
+        zmemcpy(out, from, INFLATE_CHUNK);
+        out += INFLATE_CHUNK;
+        from += INFLATE_CHUNK;
+    } while (out < stop);
+    return stop;
+}
+#endif
+
 /*
    Decode literal, length, and distance codes and write out the resulting
    literal and match bytes until either not enough input or output is
@@ -57,6 +114,11 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
     unsigned char FAR *out;     /* local strm->next_out */
     unsigned char FAR *beg;     /* inflate()'s initial strm->next_out */
     unsigned char FAR *end;     /* while out < end, enough space available */
+#ifdef INFLATE_FAST_WIDE
+    z_const unsigned char FAR *in_end;  /* end of the available input */
+    unsigned char FAR *out_end; /* end of the available output */
+    unsigned long word;         /* input bytes loaded at once */
+#endif
 #ifdef INFLATE_STRICT
     unsigned dmax;              /* maximum distance from zlib header */
 #endif
@@ -84,6 +146,10 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
     out = strm->next_out;
     beg = out - (start - strm->avail_out);
     end = out + (strm->avail_out - 257);
+#ifdef INFLATE_FAST_WIDE
+    in_end = strm->next_in + strm->avail_in;
+    out_end = out + strm->avail_out;
+#endif
 #ifdef INFLATE_STRICT
     dmax = state->dmax;
 #endif
@@ -102,10 +168,21 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
        input data or output space */
     do {
         if (bits < 15) {
-            hold += (unsigned long)(*in++) << bits;
-            bits += 8;
-            hold += (unsigned long)(*in++) << bits;
-            bits += 8;
+#ifdef INFLATE_FAST_WIDE
+            if (in_end - in >= 8) {
+                zmemcpy(&word, in, 8);
+                hold |= word << bits;
+                in += (63 - bits) >> 3;
+                bits |= 56;
+            }
+            else
+#endif
+            {
+                hold |= (unsigned long)(*in++) << bits;
+                bits += 8;
+                hold |= (unsigned long)(*in++) << bits;
+                bits += 8;
+            }
         }
         here = lcode[hold & lmask];
       dolen:
@@ -124,7 +201,7 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
             op &= 15;                           /* number of extra bits */
             if (op) {
                 if (bits < op) {
-                    hold += (unsigned long)(*in++) << bits;
+                    hold |= (unsigned long)(*in++) << bits;
                     bits += 8;
                 }
                 len += (unsigned)hold & ((1U << op) - 1);
@@ -133,10 +210,21 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
             }
             Tracevv((stderr, "inflate:         length %u\n", len));
             if (bits < 15) {
-                hold += (unsigned long)(*in++) << bits;
-                bits += 8;
-                hold += (unsigned long)(*in++) << bits;
-                bits += 8;
+#ifdef INFLATE_FAST_WIDE
+                if (in_end - in >= 8) {
+                    zmemcpy(&word, in, 8);
+                    hold |= word << bits;
+                    in += (63 - bits) >> 3;
+                    bits |= 56;
+                }
+                else
+#endif
+                {
+                    hold |= (unsigned long)(*in++) << bits;
+                    bits += 8;
+                    hold |= (unsigned long)(*in++) << bits;
+                    bits += 8;
+                }
             }
             here = dcode[hold & dmask];
           dodist:
@@ -148,10 +236,10 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
                 dist = (unsigned)(here.val);
                 op &= 15;                       /* number of extra bits */
                 if (bits < op) {
-                    hold += (unsigned long)(*in++) << bits;
+                    hold |= (unsigned long)(*in++) << bits;
                     bits += 8;
                     if (bits < op) {
-                        hold += (unsigned long)(*in++) << bits;
+                        hold |= (unsigned long)(*in++) << bits;
                         bits += 8;
                     }
                 }
@@ -249,6 +337,12 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
                     }
                 }
                 else {
+#ifdef INFLATE_FAST_WIDE
+                    if ((unsigned)(out_end - out) >= len + INFLATE_CHUNK) {
+                        out = chunk_copy(out, dist, len);
+                        continue;
+                    }
+#endif
                     from = out - dist;          /* copy direct from output */
                     do {                        /* minimum length is three */
                         *out++ = *from++;
@@ -289,7 +383,8 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
         }
     } while (in < last && out < end);
 
-    /* return unused bytes (on entry, bits < 8, so in won't go too far back) */
+    /* return unused bytes (on entry, bits < 8, so in won't go too far back);
+       this also drops any input bits a wide refill loaded past bits */
     len = bits >> 3;
     in -= len;
     bits -= len << 3;
@@ -0,0 +1,141 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QByteArray>
+#include <QDebug>
+#include <QRandomGenerator>
+
+#include <qtest.h>
+
+class tst_qcompress : public QObject
+{
+    Q_OBJECT
+private slots:
+    void compress_data();
+    void compress();
+    void uncompress_data() { compress_data(); }
+    void uncompress();
+};
+
+// Prose-like text from a small vocabulary, the kind of input rcc sees for
+// QML, JavaScript and translation files.
+static QByteArray textCorpus(int size)
+{
+    static const char *const words[] = {
+        "import", "QtQuick", "property", "string", "function", "return",
+        "width", "height", "anchors", "parent", "Item", "Rectangle", "text",
+        "color", "onClicked", "model", "delegate", "id", "var", "true"
+    };
+    const int wordCount = int(sizeof(words) / sizeof(words[0]));
+    QRandomGenerator generator(42);
+    QByteArray data;
+    data.reserve(size + 16);
+    while (data.size() < size) {
+        data += words[generator.bounded(wordCount)];
+        data += generator.bounded(8) ? ' ' : '\n';
+    }
+    data.truncate(size);
+    return data;
+}
+
+// Incompressible bytes, the worst case for the match finder.
+static QByteArray randomCorpus(int size)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    QRandomGenerator generator(42);
+    for (int i = 0; i < size; ++i)
+        data[i] = char(generator.bounded(256));
+    return data;
+}
+
+// A block repeated over and over, so that almost every match is MAX_MATCH
+// bytes long, as in images with large uniform areas.
+static QByteArray repetitiveCorpus(int size)
+{
+    const QByteArray block = textCorpus(4096);
+    QByteArray data;
+    data.reserve(size + block.size());
+    while (data.size() < size)
+        data += block;
+    data.truncate(size);
+    return data;
+}
+
+void tst_qcompress::compress_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<int>("level");
+
+    const int size = 1024 * 1024;
+    const struct {
+        const char *name;
+        QByteArray data;
+    } corpora[] = {
+        { "text", textCorpus(size) },
+        { "random", randomCorpus(size) },
+        { "repetitive", repetitiveCorpus(size) },
+    };
+    for (const auto &corpus : corpora) {
+        for (int level : { 1, 6, 9 }) {
+            QTest::addRow("%s-%d", corpus.name, level) << corpus.data << level;
+        }
+    }
+}
+
+void tst_qcompress::compress()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(int, level);
+
+    QByteArray compressed;
+    QBENCHMARK {
+        compressed = qCompress(data, level);
+    }
+    QVERIFY(!compressed.isEmpty());
+    QCOMPARE(qUncompress(compressed), data);
+    qDebug("ratio %.3f (%d -> %d bytes)",
+           double(compressed.size()) / data.size(), data.size(),
+           compressed.size());
+}
+
+void tst_qcompress::uncompress()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(int, level);
+
+    const QByteArray compressed = qCompress(data, level);
+    QByteArray uncompressed;
+    QBENCHMARK {
+        uncompressed = qUncompress(compressed);
+    }
+    QCOMPARE(uncompressed, data);
+}
+
+QTEST_MAIN(tst_qcompress)
+
+#include "main.moc"
@@ -0,0 +1,125 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file Defines a helper to run independent per-mesh work on several threads */
+#ifndef AI_PARALLELFOR_H_INC
+#define AI_PARALLELFOR_H_INC
+
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+#   include <algorithm>
+#   include <atomic>
+#   include <exception>
+#   include <mutex>
+#   include <system_error>
+#   include <thread>
+#   include <vector>
+#endif
+
+namespace Assimp    {
+
+// ---------------------------------------------------------------------------
+/** Calls func(i) for every i in [0, count), spreading the calls over the
+ *  available hardware threads.
+ *
+ *  The calls must be independent of each other, i.e. only touch data that
+ *  belongs to their index. Indices are handed out one at a time, so a few
+ *  large meshes don't leave the other threads idle. func must not log, the
+ *  logger is not thread-safe. If one of the calls throws, the remaining
+ *  indices are skipped and the first exception is rethrown on the calling
+ *  thread once all threads are done.
+ *  @param count Number of items, usually aiScene::mNumMeshes
+ *  @param func  Callable taking the item index as unsigned int
+ */
+template <typename Func>
+void ParallelFor(unsigned int count, Func func)
+{
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+    const unsigned int numThreads = std::min(count, std::thread::hardware_concurrency());
+    if (numThreads > 1) {
+        std::atomic<unsigned int> next(0);
+        std::exception_ptr error;
+        std::mutex errorMutex;
+
+        auto worker = [&]() {
+            for (unsigned int i = next++; i < count; i = next++) {
+                try {
+                    func(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                    next = count;
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(numThreads - 1);
+        try {
+            for (unsigned int t = 1; t < numThreads; ++t) {
+                threads.push_back(std::thread(worker));
+            }
+        } catch (const std::system_error&) {
+            // out of threads, go on with the ones we got
+        }
+
+        worker();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return;
+    }
+#endif
+
+    for (unsigned int i = 0; i < count; ++i) {
+        func(i);
+    }
+}
+
+} // end of namespace Assimp
+
+#endif // AI_PARALLELFOR_H_INC
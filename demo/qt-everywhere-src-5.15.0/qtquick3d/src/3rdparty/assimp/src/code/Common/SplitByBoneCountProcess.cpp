@@ -46,6 +46,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 // internal headers of the post-processing framework
 #include "SplitByBoneCountProcess.h"
+#include "Common/ParallelFor.h"
 #include <assimp/postprocess.h>
 #include <assimp/DefaultLogger.hpp>
 
@@ -106,6 +107,12 @@ void SplitByBoneCountProcess::Execute( aiScene* pScene)
     mSubMeshIndices.clear();
     mSubMeshIndices.resize( pScene->mNumMeshes);
 
+    // split the meshes independently of each other, the results are collected in order below
+    std::vector< std::vector<aiMesh*> > splitMeshes( pScene->mNumMeshes);
+    ParallelFor( pScene->mNumMeshes, [&]( unsigned int a) {
+        SplitMesh( pScene->mMeshes[a], splitMeshes[a]);
+    });
+
     // build a new array of meshes for the scene
     std::vector<aiMesh*> meshes;
 
@@ -113,8 +120,7 @@ void SplitByBoneCountProcess::Execute( aiScene* pScene)
     {
         aiMesh* srcMesh = pScene->mMeshes[a];
 
-        std::vector<aiMesh*> newMeshes;
-        SplitMesh( pScene->mMeshes[a], newMeshes);
+        const std::vector<aiMesh*>& newMeshes = splitMeshes[a];
 
         // mesh was split
         if( !newMeshes.empty() )
@@ -39,6 +39,10 @@
 #include <QtCore/QMap>
 #include <QtCore/QString>
 #include <QtCore/QTextCodec>
+#include <QtCore/QVector>
+#include <QtCore/QtEndian>
+
+#include <algorithm>
 
 QT_BEGIN_NAMESPACE
 
@@ -74,20 +78,28 @@ enum Prefix {
 
 } // namespace anon
 
+// Feeds the bytes of \a k up to the first null byte into the hash \a h, and
+// returns a pointer to that null byte.
+static const uchar *elfHashAppend(uint &h, const uchar *k)
+{
+    uint g;
+
+    while (*k) {
+        h = (h << 4) + *k++;
+        if ((g = (h & 0xf0000000)) != 0)
+            h ^= g >> 24;
+        h &= ~g;
+    }
+    return k;
+}
+
 static uint elfHash(const QByteArray &ba)
 {
     const uchar *k = (const uchar *)ba.data();
     uint h = 0;
-    uint g;
 
-    if (k) {
-        while (*k) {
-            h = (h << 4) + *k++;
-            if ((g = (h & 0xf0000000)) != 0)
-                h ^= g >> 24;
-            h &= ~g;
-        }
-    }
+    if (k)
+        elfHashAppend(h, k);
     if (!h)
         h = 1;
     return h;
@@ -172,7 +184,8 @@ private:
     // on turn should be the same as passed to the actual tr(...) calls
     QByteArray originalBytes(const QString &str) const;
 
-    static Prefix commonPrefix(const ByteTranslatorMessage &m1, const ByteTranslatorMessage &m2);
+    static Prefix commonPrefix(const ByteTranslatorMessage &m1, uint h1,
+                               const ByteTranslatorMessage &m2, uint h2);
 
     static uint msgHash(const ByteTranslatorMessage &msg);
 
@@ -202,12 +215,22 @@ QByteArray Releaser::originalBytes(const QString &str) const
 
 uint Releaser::msgHash(const ByteTranslatorMessage &msg)
 {
-    return elfHash(msg.sourceText() + msg.comment());
+    // Same as elfHash(msg.sourceText() + msg.comment()), without building the
+    // concatenation. Like there, hashing stops at the first null byte.
+    const QByteArray &sourceText = msg.sourceText();
+    uint h = 0;
+    const uchar *k = elfHashAppend(h, (const uchar *)sourceText.constData());
+    if (k == (const uchar *)sourceText.constData() + sourceText.size())
+        elfHashAppend(h, (const uchar *)msg.comment().constData());
+    if (!h)
+        h = 1;
+    return h;
 }
 
-Prefix Releaser::commonPrefix(const ByteTranslatorMessage &m1, const ByteTranslatorMessage &m2)
+Prefix Releaser::commonPrefix(const ByteTranslatorMessage &m1, uint h1,
+                              const ByteTranslatorMessage &m2, uint h2)
 {
-    if (msgHash(m1) != msgHash(m2))
+    if (h1 != h2)
         return NoPrefix;
     if (m1.context() != m2.context())
         return Hash;
@@ -302,36 +325,53 @@ void Releaser::squeeze(TranslatorSaveMode mode)
     m_contextArray.clear();
     m_messages.clear();
 
-    QMap<Offset, void *> offsets;
+    // Hash every message once, instead of once per neighbour and once more
+    // for the offset table.
+    QVector<uint> hashes;
+    hashes.reserve(messages.size());
+    QMap<ByteTranslatorMessage, void *>::const_iterator it, next;
+    for (it = messages.constBegin(); it != messages.constEnd(); ++it)
+        hashes.append(msgHash(it.key()));
+
+    QVector<Offset> offsets;
+    offsets.reserve(messages.size());
 
     QDataStream ms(&m_messageArray, QIODevice::WriteOnly);
-    QMap<ByteTranslatorMessage, void *>::const_iterator it, next;
     int cpPrev = 0, cpNext = 0;
-    for (it = messages.constBegin(); it != messages.constEnd(); ++it) {
+    int n = 0;
+    for (it = messages.constBegin(); it != messages.constEnd(); ++it, ++n) {
         cpPrev = cpNext;
         next = it;
         ++next;
         if (next == messages.constEnd())
             cpNext = 0;
         else
-            cpNext = commonPrefix(it.key(), next.key());
-        offsets.insert(Offset(msgHash(it.key()), ms.device()->pos()), (void *)0);
+            cpNext = commonPrefix(it.key(), hashes.at(n), next.key(), hashes.at(n + 1));
+        offsets.append(Offset(hashes.at(n), ms.device()->pos()));
         writeMessage(it.key(), ms, mode, Prefix(qMax(cpPrev, cpNext + 1)));
     }
 
-    QMap<Offset, void *>::Iterator offset;
-    offset = offsets.begin();
-    QDataStream ds(&m_offsetArray, QIODevice::WriteOnly);
-    while (offset != offsets.end()) {
-        Offset k = offset.key();
-        ++offset;
-        ds << quint32(k.h) << quint32(k.o);
+    // The offsets are all different, so sorting them gives the same table as
+    // inserting them in a map did.
+    std::sort(offsets.begin(), offsets.end());
+    m_offsetArray.resize(offsets.size() * 8);
+    uchar *ds = (uchar *)m_offsetArray.data();
+    for (const Offset &k : qAsConst(offsets)) {
+        qToBigEndian(quint32(k.h), ds);
+        qToBigEndian(quint32(k.o), ds + 4);
+        ds += 8;
     }
 
     if (mode == SaveStripped) {
+        // The messages are sorted by context, so each context only needs to
+        // be looked up once.
         QMap<QByteArray, int> contextSet;
-        for (it = messages.constBegin(); it != messages.constEnd(); ++it)
-            ++contextSet[it.key().context()];
+        const QByteArray *prevContext = 0;
+        for (it = messages.constBegin(); it != messages.constEnd(); ++it) {
+            if (!prevContext || *prevContext != it.key().context())
+                contextSet.insert(it.key().context(), 0);
+            prevContext = &it.key().context();
+        }
 
         quint16 hTableSize;
         if (contextSet.size() < 200)
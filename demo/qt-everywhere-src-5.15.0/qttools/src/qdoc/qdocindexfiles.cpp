@@ -152,6 +152,7 @@ void QDocIndexFiles::readIndexFile(const QString &path)
         indexUrl = installDir.relativeFilePath(path).section('/', 0, -2);
     }
     project_ = attrs.value(QLatin1String("project")).toString();
+    outputSubdirectory_ = project_.toLower();
     QString indexTitle = attrs.value(QLatin1String("indexTitle")).toString();
     basesList_.clear();
 
@@ -628,7 +629,7 @@ void QDocIndexFiles::readIndexSection(QXmlStreamReader &reader, Node *current,
         }
 
         // Create some content for the node.
-        QSet<QString> emptySet;
+        static const QSet<QString> emptySet;
         Location t(filePath);
         if (!filePath.isEmpty()) {
             t.setLineNo(lineNo);
@@ -638,7 +639,7 @@ void QDocIndexFiles::readIndexSection(QXmlStreamReader &reader, Node *current,
         Doc doc(location, location, QString(), emptySet, emptySet); // placeholder
         node->setDoc(doc);
         node->setIndexNodeFlag(); // Important: This node came from an index file.
-        node->setOutputSubdirectory(project_.toLower());
+        node->setOutputSubdirectory(outputSubdirectory_);
         QString briefAttr = attributes.value(QLatin1String("brief")).toString();
         if (!briefAttr.isEmpty()) {
             node->setReconstitutedBrief(briefAttr);
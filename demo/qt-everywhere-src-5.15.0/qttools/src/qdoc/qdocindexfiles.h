@@ -84,6 +84,7 @@ private:
     QDocDatabase *qdb_;
     Generator *gen_;
     QString project_;
+    QString outputSubdirectory_;
     QVector<QPair<ClassNode *, QString>> basesList_;
     bool storeLocationInfo_;
 };
@@ -0,0 +1,125 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QByteArray>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QXmlStreamReader>
+
+#include <qtest.h>
+
+class tst_QDocIndexFiles : public QObject
+{
+    Q_OBJECT
+private slots:
+    void readIndex_data();
+    void readIndex();
+
+private:
+    QTemporaryDir dir;
+};
+
+// An index file shaped like the ones qdoc writes for the Qt modules: classes
+// holding functions, each element carrying a dozen attributes. 700 classes
+// make it about as large as qtcore.index, some 9 MB.
+static QByteArray indexCorpus(int classCount)
+{
+    QByteArray data = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                      "<!DOCTYPE QDOCINDEX>\n"
+                      "<INDEX url=\"http://doc.qt.io/qt-5\" title=\"Qt Core Reference Documentation\""
+                      " version=\"5.15.0\" project=\"QtCore\">\n"
+                      "<namespace name=\"\" status=\"active\" access=\"public\" module=\"qtcore\">\n";
+    for (int c = 0; c < classCount; ++c) {
+        const QByteArray cls = "QClass" + QByteArray::number(c);
+        data += "<class name=\"" + cls + "\" href=\"" + cls.toLower() + ".html\" status=\"active\""
+                " access=\"public\" location=\"" + cls.toLower() + ".h\" documented=\"true\""
+                " module=\"QtCore\" brief=\"Provides the " + cls + " facilities\">\n";
+        for (int f = 0; f < 40; ++f) {
+            const QByteArray fn = "function" + QByteArray::number(f);
+            data += "<function name=\"" + fn + "\" fullname=\"" + cls + "::" + fn + "\" href=\""
+                    + cls.toLower() + ".html#" + fn + "\" status=\"active\" access=\"public\""
+                    " location=\"" + cls.toLower() + ".h\" documented=\"true\" meta=\"plain\""
+                    " virtual=\"non\" const=\"true\" static=\"false\" final=\"false\""
+                    " override=\"false\" type=\"int\" signature=\"int " + fn + "() const\"/>\n";
+        }
+        data += "</class>\n";
+    }
+    data += "</namespace>\n</INDEX>\n";
+    return data;
+}
+
+void tst_QDocIndexFiles::readIndex_data()
+{
+    QTest::addColumn<QString>("path");
+    QTest::addColumn<int>("classCount");
+
+    QVERIFY(dir.isValid());
+    for (int classCount : { 50, 700 }) {
+        const QString path = dir.filePath(QString::number(classCount) + ".index");
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        const QByteArray data = indexCorpus(classCount);
+        QCOMPARE(file.write(data), qint64(data.size()));
+        QTest::addRow("%d-classes", classCount) << path << classCount;
+    }
+}
+
+// Parses the index the way QDocIndexFiles::readIndexFile() does, through the
+// file and reading every attribute, without building the node tree.
+void tst_QDocIndexFiles::readIndex()
+{
+    QFETCH(QString, path);
+    QFETCH(int, classCount);
+
+    int elements = 0;
+    qint64 characters = 0;
+    QBENCHMARK {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QXmlStreamReader reader(&file);
+        reader.setNamespaceProcessing(false);
+
+        elements = 0;
+        characters = 0;
+        while (!reader.atEnd()) {
+            if (reader.readNext() == QXmlStreamReader::StartElement) {
+                const QXmlStreamAttributes attributes = reader.attributes();
+                for (const QXmlStreamAttribute &attribute : attributes)
+                    characters += attribute.value().size();
+                ++elements;
+            }
+        }
+        QVERIFY(!reader.hasError());
+    }
+    QCOMPARE(elements, 2 + classCount * 41);
+    QVERIFY(characters > 0);
+}
+
+QTEST_MAIN(tst_QDocIndexFiles)
+
+#include "main.moc"
@@ -1593,6 +1593,48 @@ int NNShapeRecognizer::computeDTWDistance(
 }
 
 
+/**********************************************************************************
+ * NAME			: computeBoundedDTWDistance
+ * DESCRIPTION	: computes the DTW distance between two characters, stopping early
+ *				  once it is known to exceed inBound
+ * ARGUMENTS		: train character, test character, bound
+ * RETURNS		: DTWDistance, larger than inBound if the computation was abandoned
+ * NOTES			: inBound is a normalized distance, the DTW works on the
+ *				  cumulative one, hence the scaling. The slack keeps rounding from
+ *				  abandoning a prototype exactly at the bound.
+ * CHANGE HISTROY
+ * Author			Date				Description
+ *************************************************************************************/
+int NNShapeRecognizer::computeBoundedDTWDistance(
+        const LTKShapeSample& inFirstShapeSampleFeatures,
+        const LTKShapeSample& inSecondShapeSampleFeatures,
+        float inBound,
+        float& outDTWDistance)
+{
+    const vector<LTKShapeFeaturePtr>& firstFeatureVec = inFirstShapeSampleFeatures.getFeatureVector();
+    const vector<LTKShapeFeaturePtr>& secondFeatureVec = inSecondShapeSampleFeatures.getFeatureVector();
+
+    float cumulativeBound = FLT_MAX;
+    if(inBound < FLT_MAX)
+    {
+        cumulativeBound = inBound * (firstFeatureVec.size() + secondFeatureVec.size()) * 1.0001f;
+    }
+
+    int errorCode = m_dtwObj.computeDTW(firstFeatureVec, secondFeatureVec, getDistance,outDTWDistance,
+            m_dtwBanding, cumulativeBound, FLT_MAX);
+
+    if (errorCode != SUCCESS )
+    {
+        LOG(LTKLogger::LTK_LOGLEVEL_DEBUG)<<"Error: "<<
+            getErrorMessage(errorCode) <<
+            " NNShapeRecognizer::computeBoundedDTWDistance()" << endl;
+        LTKReturnError(errorCode);
+    }
+
+    return SUCCESS;
+}
+
+
 /**********************************************************************************
  * AUTHOR		: Sridhar Krishna
  * DATE			: 24-04-2006
@@ -2415,15 +2457,38 @@ int NNShapeRecognizer::recognize(const vector<LTKShapeFeaturePtr>& shapeFeatureV
         }
 
 
+        // Only the nearest prototype of every class (1-NN), or the m_nearestNeighbors nearest
+        // prototypes overall (k-NN), take part in computeConfidence() and adaptation. A prototype
+        // farther away than that so far can be given up on as soon as the DTW shows it.
+        map<int, float> classNearestDistance;
+        vector<float> nearestDistancesHeap;
+
         //Iterate through all the prototypes, and compute DTW distance to the prototypes for which corresponding entry in filterVector is true
         for (int i = 0 ; i < m_prototypeSet.size(); ++i )
         {
 
             if(filterVector[i])
             {
+                const int classId = m_prototypeSet[i].getClassID();
+                float bound = FLT_MAX;
+
+                if(m_nearestNeighbors <= 1)
+                {
+                    map<int, float>::const_iterator nearestIter = classNearestDistance.find(classId);
+                    if(nearestIter != classNearestDistance.end())
+                    {
+                        bound = nearestIter->second;
+                    }
+                }
+                else if(nearestDistancesHeap.size() >= m_nearestNeighbors)
+                {
+                    bound = nearestDistancesHeap.front();
+                }
+
 				dtwDistance = 0.0f;
-                errorCode = computeDTWDistance(m_prototypeSet[i],
+                errorCode = computeBoundedDTWDistance(m_prototypeSet[i],
                         m_cachedShapeSampleFeatures,
+                        bound,
                         dtwDistance);
 
                 if(errorCode == SUCCESS && m_cancelRecognition)
@@ -2437,8 +2502,28 @@ int NNShapeRecognizer::recognize(const vector<LTKShapeFeaturePtr>& shapeFeatureV
                     LTKReturnError(errorCode);
                 }
 
+                if(dtwDistance > bound)
+                {
+                    continue;
+                }
+
+                if(m_nearestNeighbors <= 1)
+                {
+                    classNearestDistance[classId] = dtwDistance;
+                }
+                else
+                {
+                    if(nearestDistancesHeap.size() >= m_nearestNeighbors)
+                    {
+                        pop_heap(nearestDistancesHeap.begin(), nearestDistancesHeap.end());
+                        nearestDistancesHeap.pop_back();
+                    }
+                    nearestDistancesHeap.push_back(dtwDistance);
+                    push_heap(nearestDistancesHeap.begin(), nearestDistancesHeap.end());
+                }
+
                 tempPair.distance = dtwDistance;
-                tempPair.classId = (m_prototypeSet[i]).getClassID();
+                tempPair.classId = classId;
                 tempPair.prototypeSetIndex = i;
                 m_neighborInfoVec.push_back(tempPair);
             }
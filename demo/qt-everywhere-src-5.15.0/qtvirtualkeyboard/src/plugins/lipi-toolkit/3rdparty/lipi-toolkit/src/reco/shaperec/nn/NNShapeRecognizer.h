@@ -707,6 +707,20 @@ class NNShapeRecognizer: public LTKShapeRecognizer
                                const LTKShapeSample& inSecondShapeSampleFeatures,
                                float& outDTWDistance);
 
+        /**
+         * This function computes the Dtw distance between the two characters, giving up as
+         * soon as it is known to be larger than the given bound.
+         * @param inFirstShapeSampleFeatures The training character.
+         * @param inSecondShapeSampleFeatures The testing character.
+         * @param inBound Distance beyond which the exact value is not needed, FLT_MAX for none.
+         * @param outDTWDistance The Dtw distance, or a value larger than inBound if it was
+         *                       given up on.
+         */
+        int computeBoundedDTWDistance(const LTKShapeSample& inFirstShapeSampleFeatures,
+                                      const LTKShapeSample& inSecondShapeSampleFeatures,
+                                      float inBound,
+                                      float& outDTWDistance);
+
 
 
 
@@ -493,6 +493,22 @@ class DynamicTimeWarping
             
             (localDistPtr)(train[0],test[0],previousRow[0]);
 
+            /**
+              Every warping path starts at the first and ends at the last pair of
+              elements, so the sum of their local distances is a lower bound of the
+              DTW distance. It lets us give up before filling the matrix.
+             */
+            if(bestSoFar < m_maxVal && (trainSize > 1 || testSize > 1))
+            {
+                (localDistPtr)(train[trainSize-1],test[testSize-1],tempVal);
+
+                if(previousRow[0] + tempVal > bestSoFar)
+                {
+                    distanceDTW = m_maxVal;
+                    return SUCCESS;
+                }
+            }
+
             /**
               Computing the first row of the distance matrix.
              */
@@ -511,12 +527,16 @@ class DynamicTimeWarping
 
             for(i = 1; i < trainSize; ++i)
             {
-                rowMin = m_maxVal;
-
-
                 localDistPtr(train[i],test[trunkJ],tempVal);
                 currentRow[trunkJ]=tempVal+previousRow[trunkJ];
 
+                /**
+                  Every warping path crosses this row within the band, so the
+                  minimum has to include the first cell as well, the only one
+                  of the row when testSize is 1.
+                 */
+                rowMin = currentRow[trunkJ];
+
                 for(j = 1+trunkJ; j < testSize-trunkI; ++j)
                 {
 
@@ -554,7 +574,8 @@ class DynamicTimeWarping
                 copy(currentRow.begin()+trunkJ, currentRow.end()-trunkI, previousRow.begin()+trunkJ);
             }
 
-            distanceDTW = tempMinDist;
+            // The last cell, also when the loops above computed no cell of their own
+            distanceDTW = previousRow[testSize-1];
 			distanceDTW = distanceDTW/(trainSize + testSize);
 
 		    return SUCCESS;
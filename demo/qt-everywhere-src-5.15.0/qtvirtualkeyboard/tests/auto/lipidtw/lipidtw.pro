@@ -0,0 +1,13 @@
+CONFIG += testcase
+TARGET = tst_lipidtw
+
+macos:CONFIG -= app_bundle
+
+LIPI_SRC = $$PWD/../../../src/plugins/lipi-toolkit/3rdparty/lipi-toolkit/src
+INCLUDEPATH += \
+    $$LIPI_SRC/include \
+    $$LIPI_SRC/util/lib
+
+SOURCES += tst_lipidtw.cpp
+
+QT = core testlib
@@ -0,0 +1,138 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <cfloat>
+
+#include "LTKInc.h"
+#include "LTKMacros.h"
+#include "LTKErrorsList.h"
+#include "LTKDynamicTimeWarping.h"
+
+typedef DynamicTimeWarping<float, float> FloatDTW;
+
+static void localDistance(const float &first, const float &second, float &distance)
+{
+    distance = qAbs(first - second);
+}
+
+static vector<float> series(quint32 &seed, int size)
+{
+    vector<float> result(size);
+    for (int i = 0; i < size; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        result[i] = float((seed >> 16) % 100) / 10.0f;
+    }
+    return result;
+}
+
+class tst_LipiDtw : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void singleTestElement();
+    void boundedMatchesUnbounded_data();
+    void boundedMatchesUnbounded();
+};
+
+// A one element test series leaves the inner loop of every row empty, the
+// row minimum is then the first cell alone.
+void tst_LipiDtw::singleTestElement()
+{
+    FloatDTW dtw;
+    vector<float> train;
+    train.push_back(1.0f);
+    train.push_back(2.0f);
+    train.push_back(3.0f);
+    const vector<float> test(1, 2.0f);
+
+    float unbounded = 0.0f;
+    QCOMPARE(dtw.computeDTW(train, test, localDistance, unbounded, 1.0f, FLT_MAX, FLT_MAX), SUCCESS);
+    QCOMPARE(unbounded, 0.5f);
+
+    float bounded = 0.0f;
+    QCOMPARE(dtw.computeDTW(train, test, localDistance, bounded, 1.0f, 2.0f, FLT_MAX), SUCCESS);
+    QCOMPARE(bounded, unbounded);
+
+    QCOMPARE(dtw.computeDTW(train, test, localDistance, bounded, 1.0f, 1.9f, FLT_MAX), SUCCESS);
+    QCOMPARE(bounded, FLT_MAX);
+}
+
+void tst_LipiDtw::boundedMatchesUnbounded_data()
+{
+    QTest::addColumn<int>("trainSize");
+    QTest::addColumn<int>("testSize");
+    QTest::addColumn<float>("banding");
+
+    QTest::newRow("1x1") << 1 << 1 << 1.0f;
+    QTest::newRow("1x7") << 1 << 7 << 1.0f;
+    QTest::newRow("7x1") << 7 << 1 << 1.0f;
+    QTest::newRow("7x1 banded") << 7 << 1 << 0.33f;
+    QTest::newRow("2x2") << 2 << 2 << 1.0f;
+    QTest::newRow("12x9") << 12 << 9 << 1.0f;
+    QTest::newRow("12x9 banded") << 12 << 9 << 0.33f;
+    QTest::newRow("20x20 banded") << 20 << 20 << 0.5f;
+}
+
+// Exactly at the distance the bound must not change the result, and just
+// below it the result must exceed the bound, abandoned or not.
+void tst_LipiDtw::boundedMatchesUnbounded()
+{
+    QFETCH(int, trainSize);
+    QFETCH(int, testSize);
+    QFETCH(float, banding);
+
+    FloatDTW dtw;
+    quint32 seed = quint32(trainSize * 31 + testSize);
+
+    for (int round = 0; round < 200; ++round) {
+        const vector<float> train = series(seed, trainSize);
+        const vector<float> test = series(seed, testSize);
+
+        float unbounded = 0.0f;
+        QCOMPARE(dtw.computeDTW(train, test, localDistance, unbounded, banding, FLT_MAX, FLT_MAX), SUCCESS);
+
+        const float cumulative = unbounded * (trainSize + testSize);
+
+        float bounded = 0.0f;
+        QCOMPARE(dtw.computeDTW(train, test, localDistance, bounded, banding, cumulative * 1.0001f, FLT_MAX), SUCCESS);
+        QCOMPARE(bounded, unbounded);
+
+        if (cumulative > 0.0f) {
+            const float bound = cumulative * 0.999f;
+            QCOMPARE(dtw.computeDTW(train, test, localDistance, bounded, banding, bound, FLT_MAX), SUCCESS);
+            QVERIFY(bounded == FLT_MAX || bounded * (trainSize + testSize) > bound);
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_LipiDtw)
+
+#include "tst_lipidtw.moc"
@@ -288,6 +288,14 @@ void PartitionRootGeneric::Init() {
   *bucket_ptr = internal::PartitionBucket::get_sentinel_bucket();
 }
 
+void PartitionRootGeneric::EnableThreadCache() {
+  DCHECK(initialized);
+  DCHECK(!thread_caches);
+  DCHECK_EQ(buckets[internal::ThreadCache::kNumBuckets - 1].slot_size,
+            internal::ThreadCache::kMaxCachedSlotSize);
+  thread_caches = std::make_unique<internal::ThreadCacheRegistry>(this);
+}
+
 bool PartitionReallocDirectMappedInPlace(PartitionRootGeneric* root,
                                          internal::PartitionPage* page,
                                          size_t raw_size) {
@@ -619,6 +627,11 @@ void PartitionRoot::PurgeMemory(int flags) {
 }
 
 void PartitionRootGeneric::PurgeMemory(int flags) {
+  // Slots held by thread caches keep their pages from being empty or
+  // discardable, so return them first. This takes |lock| itself.
+  if (thread_caches)
+    thread_caches->PurgeAll();
+
   subtle::SpinLock::Guard guard(lock);
   if (flags & PartitionPurgeDecommitEmptyPages)
     DecommitEmptyPages();
@@ -33,6 +33,8 @@
 //
 // And for PartitionRootGeneric::Alloc():
 // - Multi-threaded use against a single partition is ok; locking is handled.
+// A per-thread cache of small slots can be enabled to take the lock off the
+// fast path (see PartitionRootGeneric::EnableThreadCache()).
 // - Allocations of any arbitrary size can be handled (subject to a limit of
 // INT_MAX bytes for security reasons).
 // - Bucketing is by approximate size, for example an allocation of 4000 bytes
@@ -63,6 +65,8 @@
 #include <limits.h>
 #include <string.h>
 
+#include <memory>
+
 #include "base/allocator/partition_allocator/memory_reclaimer.h"
 #include "base/allocator/partition_allocator/page_allocator.h"
 #include "base/allocator/partition_allocator/partition_alloc_constants.h"
@@ -71,6 +75,7 @@
 #include "base/allocator/partition_allocator/partition_page.h"
 #include "base/allocator/partition_allocator/partition_root_base.h"
 #include "base/allocator/partition_allocator/spin_lock.h"
+#include "base/allocator/partition_allocator/thread_cache.h"
 #include "base/base_export.h"
 #include "base/bits.h"
 #include "base/compiler_specific.h"
@@ -152,10 +157,20 @@ struct BASE_EXPORT PartitionRootGeneric : public internal::PartitionRootBase {
       bucket_lookups[((kBitsPerSizeT + 1) * kGenericNumBucketsPerOrder) + 1] =
           {};
   internal::PartitionBucket buckets[kGenericNumBuckets] = {};
+  // Non-null once EnableThreadCache() has been called.
+  std::unique_ptr<internal::ThreadCacheRegistry> thread_caches;
 
   // Public API.
   void Init();
 
+  // Serves allocations and frees of small slots (up to
+  // internal::ThreadCache::kMaxCachedSlotSize) from a per-thread cache, which
+  // only takes |lock| to refill or flush batches of slots. Costs up to a few
+  // hundred KiB of cached free slots per thread using the partition, which
+  // PurgeMemory() returns. Must be called after Init(), before the partition
+  // is used from more than one thread.
+  void EnableThreadCache();
+
   ALWAYS_INLINE void* Alloc(size_t size, const char* type_name);
   ALWAYS_INLINE void* AllocFlags(int flags, size_t size, const char* type_name);
   ALWAYS_INLINE void Free(void* ptr);
@@ -419,7 +434,21 @@ ALWAYS_INLINE void* PartitionAllocGenericFlags(PartitionRootGeneric* root,
   size_t requested_size = size;
   size = internal::PartitionCookieSizeAdjustAdd(size);
   internal::PartitionBucket* bucket = PartitionGenericSizeToBucket(root, size);
-  {
+  result = nullptr;
+  if (root->thread_caches &&
+      size <= internal::ThreadCache::kMaxCachedSlotSize) {
+    // |size| being small enough guarantees that |bucket| is one of the first
+    // ThreadCache::kNumBuckets buckets.
+    internal::ThreadCache* thread_cache = root->thread_caches->GetOrCreate();
+    if (LIKELY(thread_cache)) {
+      void* slot_start = thread_cache->GetFromCache(bucket - root->buckets);
+      if (LIKELY(slot_start)) {
+        result = PartitionRootGeneric::PrepareSlotForCaller(slot_start, flags,
+                                                            size, false);
+      }
+    }
+  }
+  if (!result) {
     subtle::SpinLock::Guard guard(root->lock);
     result = root->AllocFromBucket(bucket, flags, size);
   }
@@ -462,6 +491,16 @@ ALWAYS_INLINE void PartitionRootGeneric::Free(void* ptr) {
   internal::PartitionPage* page = internal::PartitionPage::FromPointer(ptr);
   // TODO(palmer): See if we can afford to make this a CHECK.
   DCHECK(IsValidPage(page));
+  if (thread_caches &&
+      page->bucket->slot_size <= internal::ThreadCache::kMaxCachedSlotSize) {
+    // Only threads which allocate from the partition get a cache, so that
+    // threads which merely free objects don't hoard slots.
+    internal::ThreadCache* thread_cache = thread_caches->Get();
+    if (LIKELY(thread_cache)) {
+      thread_cache->PutInCache(ptr, page->bucket - buckets);
+      return;
+    }
+  }
   {
     subtle::SpinLock::Guard guard(lock);
     page->Free(ptr);
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include <atomic>
+#include <memory>
 #include <vector>
 
 #include "base/allocator/partition_allocator/partition_alloc.h"
@@ -60,6 +61,48 @@ class AllocatingThread : public PlatformThread::Delegate {
   PlatformThreadHandle thread_handle_;
 };
 
+// Allocates and frees objects of various sizes until destroyed, keeping a
+// small working set alive, as a renderer thread churning through DOM and
+// style objects would.
+class ChurningThread : public PlatformThread::Delegate {
+ public:
+  explicit ChurningThread(PartitionAllocatorGeneric* allocator)
+      : allocator_(allocator), should_stop_(false) {
+    PlatformThread::Create(0, this, &thread_handle_);
+  }
+
+  ~ChurningThread() override {
+    should_stop_ = true;
+    PlatformThread::Join(thread_handle_);
+  }
+
+  // Allocates and frees memory in a loop until |should_stop_| becomes true.
+  void ThreadMain() override {
+    void* working_set[kMultiBucketRounds] = {};
+    uint64_t count = 0;
+    while (true) {
+      // Only check |should_stop_| every 2^10 rounds, as it is a sequentially
+      // consistent access, hence expensive.
+      if (count % (1 << 10) == 0 && should_stop_)
+        break;
+      for (int i = 0; i < kMultiBucketRounds; i++) {
+        void* cur = allocator_->root()->Alloc(
+            kMultiBucketMinimumSize + (i * kMultiBucketIncrement), "<testing>");
+        CHECK_NE(cur, nullptr);
+        allocator_->root()->Free(working_set[i]);
+        working_set[i] = cur;
+      }
+      count++;
+    }
+    for (void* ptr : working_set)
+      allocator_->root()->Free(ptr);
+  }
+
+  PartitionAllocatorGeneric* allocator_;
+  std::atomic<bool> should_stop_;
+  PlatformThreadHandle thread_handle_;
+};
+
 void DisplayResults(const std::string& measurement,
                     const std::string& modifier,
                     size_t iterations_per_second) {
@@ -253,6 +296,26 @@ TEST_F(MemoryAllocationPerfTest, MultiBucketWithFreeWithCompetingThread) {
   TestMultiBucketWithFree();
 }
 
+// Number of ChurningThreads competing with the measured thread in the
+// multi-threaded tests.
+constexpr int kChurningThreads = 3;
+
+TEST_F(MemoryAllocationPerfTest, MultiBucketWithFreeWithChurningThreads) {
+  std::vector<std::unique_ptr<ChurningThread>> threads;
+  for (int i = 0; i < kChurningThreads; i++)
+    threads.push_back(std::make_unique<ChurningThread>(&alloc_));
+  TestMultiBucketWithFree();
+}
+
+TEST_F(MemoryAllocationPerfTest,
+       MultiBucketWithFreeWithChurningThreadsThreadCache) {
+  alloc_.root()->EnableThreadCache();
+  std::vector<std::unique_ptr<ChurningThread>> threads;
+  for (int i = 0; i < kChurningThreads; i++)
+    threads.push_back(std::make_unique<ChurningThread>(&alloc_));
+  TestMultiBucketWithFree();
+}
+
 }  // anonymous namespace
 
 }  // namespace base
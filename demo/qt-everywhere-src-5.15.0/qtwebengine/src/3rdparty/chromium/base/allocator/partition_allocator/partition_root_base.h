@@ -70,6 +70,20 @@ struct BASE_EXPORT PartitionRootBase {
                                       int flags,
                                       size_t size);
 
+  // The two halves of AllocFromBucket(). AllocSlotFromBucket() takes a slot
+  // out of |bucket| and returns its start, and must be called under the
+  // partition lock, if any. PrepareSlotForCaller() writes the cookies and fill
+  // pattern, and returns the pointer to hand out. It only reads immutable
+  // metadata for non-direct-mapped buckets, so may then run without the lock.
+  ALWAYS_INLINE void* AllocSlotFromBucket(PartitionBucket* bucket,
+                                          int flags,
+                                          size_t size,
+                                          bool* is_already_zeroed);
+  ALWAYS_INLINE static void* PrepareSlotForCaller(void* slot_start,
+                                                  int flags,
+                                                  size_t size,
+                                                  bool is_already_zeroed);
+
   ALWAYS_INLINE static bool IsValidPage(PartitionPage* page);
   ALWAYS_INLINE static PartitionRootBase* FromPage(PartitionPage* page);
 
@@ -91,9 +105,16 @@ struct BASE_EXPORT PartitionRootBase {
 ALWAYS_INLINE void* PartitionRootBase::AllocFromBucket(PartitionBucket* bucket,
                                                        int flags,
                                                        size_t size) {
-  bool zero_fill = flags & PartitionAllocZeroFill;
   bool is_already_zeroed = false;
+  void* ret = AllocSlotFromBucket(bucket, flags, size, &is_already_zeroed);
+  return PrepareSlotForCaller(ret, flags, size, is_already_zeroed);
+}
 
+ALWAYS_INLINE void* PartitionRootBase::AllocSlotFromBucket(
+    PartitionBucket* bucket,
+    int flags,
+    size_t size,
+    bool* is_already_zeroed) {
   PartitionPage* page = bucket->active_pages_head;
   // Check that this page is neither full nor freed.
   DCHECK(page->num_allocated_slots >= 0);
@@ -112,18 +133,28 @@ ALWAYS_INLINE void* PartitionRootBase::AllocFromBucket(PartitionBucket* bucket,
     page->freelist_head = new_head;
     page->num_allocated_slots++;
   } else {
-    ret = bucket->SlowPathAlloc(this, flags, size, &is_already_zeroed);
+    ret = bucket->SlowPathAlloc(this, flags, size, is_already_zeroed);
     // TODO(palmer): See if we can afford to make this a CHECK.
     DCHECK(!ret ||
            PartitionRootBase::IsValidPage(PartitionPage::FromPointer(ret)));
   }
+  return ret;
+}
+
+ALWAYS_INLINE void* PartitionRootBase::PrepareSlotForCaller(
+    void* slot_start,
+    int flags,
+    size_t size,
+    bool is_already_zeroed) {
+  bool zero_fill = flags & PartitionAllocZeroFill;
+  void* ret = slot_start;
 
 #if DCHECK_IS_ON()
   if (!ret) {
     return nullptr;
   }
 
-  page = PartitionPage::FromPointer(ret);
+  PartitionPage* page = PartitionPage::FromPointer(ret);
   // TODO(ajwong): Can |page->bucket| ever not be |this|? If not, can this just
   // be bucket->slot_size?
   size_t new_slot_size = page->bucket->slot_size;
@@ -0,0 +1,190 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/allocator/partition_allocator/thread_cache.h"
+
+#include <algorithm>
+
+#include "base/allocator/partition_allocator/partition_alloc.h"
+#include "base/allocator/partition_allocator/partition_page.h"
+
+namespace base {
+namespace internal {
+
+ThreadCache::ThreadCache(PartitionRootGeneric* root,
+                         ThreadCacheRegistry* registry)
+    : root_(root), registry_(registry) {
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    Bucket& bucket = buckets_[i];
+    bucket.freelist_head = nullptr;
+    bucket.count = 0;
+    bucket.slot_size = root_->buckets[i].slot_size;
+    // Pseudo buckets are never looked up, their limit doesn't matter.
+    size_t limit = kMaxBytesPerBucket / std::max<size_t>(bucket.slot_size, 1);
+    bucket.limit = static_cast<uint16_t>(
+        std::max<size_t>(kMinCountPerBucket,
+                         std::min<size_t>(kMaxCountPerBucket, limit)));
+  }
+}
+
+ThreadCache::~ThreadCache() = default;
+
+void* ThreadCache::GetFromCacheSlowPath(size_t bucket_index) {
+  Bucket& bucket = buckets_[bucket_index];
+  DCHECK(!bucket.freelist_head);
+  DCHECK(!bucket.count);
+  PartitionBucket* central_bucket = &root_->buckets[bucket_index];
+
+  // Grab half a cache worth of slots at once. Failing to allocate is not fatal
+  // here, as the caller falls back to the regular path, which handles OOM
+  // according to its flags.
+  const uint16_t batch_size = bucket.limit / 2;
+  {
+    subtle::SpinLock::Guard guard(root_->lock);
+    for (uint16_t i = 0; i < batch_size; ++i) {
+      bool is_already_zeroed = false;
+      void* slot_start = root_->AllocSlotFromBucket(
+          central_bucket, PartitionAllocReturnNull, bucket.slot_size,
+          &is_already_zeroed);
+      if (!slot_start)
+        break;
+      auto* entry = static_cast<PartitionFreelistEntry*>(slot_start);
+      entry->next = PartitionFreelistEntry::Encode(bucket.freelist_head);
+      bucket.freelist_head = entry;
+      bucket.count++;
+    }
+  }
+  cached_bytes_ += bucket.count * bucket.slot_size;
+
+  if (!bucket.freelist_head)
+    return nullptr;
+  return GetFromCache(bucket_index);
+}
+
+void ThreadCache::FlushBucket(Bucket* bucket, uint16_t count_to_keep) {
+  DCHECK(bucket->count > count_to_keep);
+
+  // Keep the most recently freed slots, as they are the likeliest to still be
+  // in the CPU caches, and return the older ones.
+  PartitionFreelistEntry* to_flush;
+  if (!count_to_keep) {
+    to_flush = bucket->freelist_head;
+    bucket->freelist_head = nullptr;
+  } else {
+    PartitionFreelistEntry* last_kept = bucket->freelist_head;
+    for (uint16_t i = 1; i < count_to_keep; ++i)
+      last_kept = EncodedPartitionFreelistEntry::Decode(last_kept->next);
+    to_flush = EncodedPartitionFreelistEntry::Decode(last_kept->next);
+    last_kept->next = PartitionFreelistEntry::Encode(nullptr);
+  }
+  cached_bytes_ -= (bucket->count - count_to_keep) * bucket->slot_size;
+  bucket->count = count_to_keep;
+
+  subtle::SpinLock::Guard guard(root_->lock);
+  while (to_flush) {
+    PartitionFreelistEntry* next =
+        EncodedPartitionFreelistEntry::Decode(to_flush->next);
+#if DCHECK_IS_ON()
+    // PartitionPage::Free() checks the cookies, which were overwritten when
+    // the slot entered the cache.
+    PartitionCookieWriteValue(to_flush);
+    PartitionCookieWriteValue(reinterpret_cast<char*>(to_flush) +
+                              bucket->slot_size - kCookieSize);
+#endif
+    PartitionPage::FromPointer(to_flush)->Free(to_flush);
+    to_flush = next;
+  }
+}
+
+void ThreadCache::Purge() {
+  for (Bucket& bucket : buckets_) {
+    if (bucket.count)
+      FlushBucket(&bucket, 0);
+  }
+  DCHECK(!cached_bytes_);
+}
+
+void ThreadCache::PurgeIfRequested() {
+  should_purge_.store(false, std::memory_order_relaxed);
+  Purge();
+}
+
+ThreadCacheRegistry::ThreadCacheRegistry(PartitionRootGeneric* root)
+    : root_(root), slot_(&ThreadCacheRegistry::OnThreadExit) {}
+
+ThreadCacheRegistry::~ThreadCacheRegistry() {
+  // The partition is going away. The remaining caches belong to threads which
+  // are still alive, and their slots are not worth returning. These threads
+  // won't see the caches anymore, since destroying |slot_| invalidates it.
+  subtle::SpinLock::Guard guard(lock_);
+  while (head_) {
+    ThreadCache* cache = head_;
+    head_ = cache->next_;
+    delete cache;
+  }
+}
+
+ThreadCache* ThreadCacheRegistry::Get() {
+  // Frees can come from other TLS destructors while the thread exits, after
+  // the TLS slots of this thread are gone.
+  if (UNLIKELY(ThreadLocalStorage::HasBeenDestroyed()))
+    return nullptr;
+  return static_cast<ThreadCache*>(slot_.Get());
+}
+
+ThreadCache* ThreadCacheRegistry::GetOrCreate() {
+  if (UNLIKELY(ThreadLocalStorage::HasBeenDestroyed()))
+    return nullptr;
+  auto* cache = static_cast<ThreadCache*>(slot_.Get());
+  if (LIKELY(cache))
+    return cache;
+
+  cache = new ThreadCache(root_, this);
+  slot_.Set(cache);
+  Register(cache);
+  return cache;
+}
+
+void ThreadCacheRegistry::PurgeAll() {
+  ThreadCache* current = Get();
+  {
+    subtle::SpinLock::Guard guard(lock_);
+    for (ThreadCache* cache = head_; cache; cache = cache->next_) {
+      if (cache != current)
+        cache->should_purge_.store(true, std::memory_order_relaxed);
+    }
+  }
+  if (current)
+    current->Purge();
+}
+
+// static
+void ThreadCacheRegistry::OnThreadExit(void* value) {
+  auto* cache = static_cast<ThreadCache*>(value);
+  cache->Purge();
+  cache->registry_->Unregister(cache);
+  delete cache;
+}
+
+void ThreadCacheRegistry::Register(ThreadCache* cache) {
+  subtle::SpinLock::Guard guard(lock_);
+  cache->next_ = head_;
+  cache->prev_ = nullptr;
+  if (head_)
+    head_->prev_ = cache;
+  head_ = cache;
+}
+
+void ThreadCacheRegistry::Unregister(ThreadCache* cache) {
+  subtle::SpinLock::Guard guard(lock_);
+  if (cache->prev_)
+    cache->prev_->next_ = cache->next_;
+  else
+    head_ = cache->next_;
+  if (cache->next_)
+    cache->next_->prev_ = cache->prev_;
+}
+
+}  // namespace internal
+}  // namespace base
@@ -0,0 +1,179 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_ALLOCATOR_PARTITION_ALLOCATOR_THREAD_CACHE_H_
+#define BASE_ALLOCATOR_PARTITION_ALLOCATOR_THREAD_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+
+#include "base/allocator/partition_allocator/partition_alloc_constants.h"
+#include "base/allocator/partition_allocator/partition_cookie.h"
+#include "base/allocator/partition_allocator/partition_freelist_entry.h"
+#include "base/allocator/partition_allocator/spin_lock.h"
+#include "base/base_export.h"
+#include "base/compiler_specific.h"
+#include "base/logging.h"
+#include "base/macros.h"
+#include "base/threading/thread_local_storage.h"
+
+namespace base {
+
+struct PartitionRootGeneric;
+
+namespace internal {
+
+class ThreadCacheRegistry;
+
+// Per-thread cache of free slots for the small buckets of a
+// PartitionRootGeneric.
+//
+// Slots held by a thread cache are still accounted as allocated in their
+// partition page, so the central bucket freelists never see them. The cache is
+// refilled from, and flushed to, the central buckets in batches, which amortizes
+// the cost of taking |PartitionRootGeneric::lock| over many allocations.
+//
+// A ThreadCache is only ever touched by its owning thread, with the exception
+// of |should_purge_|, which other threads set to ask the owner to return all
+// its slots at the next opportunity (see ThreadCacheRegistry::PurgeAll()).
+class BASE_EXPORT ThreadCache {
+ public:
+  // Only buckets in the first |kBucketedOrders| orders are cached. With the
+  // default bucket layout, this covers slot sizes up to 480 bytes.
+  static constexpr size_t kBucketedOrders = 6;
+  static constexpr size_t kNumBuckets =
+      kBucketedOrders * kGenericNumBucketsPerOrder;
+  static constexpr size_t kMaxCachedSlotSize =
+      (1 << (kGenericMinBucketedOrder - 1 + kBucketedOrders)) -
+      (1 << (kGenericMinBucketedOrder - 2 + kBucketedOrders -
+             kGenericNumBucketsPerOrderBits));
+  // Upper bound on the memory held per bucket, and on the slot count for tiny
+  // slot sizes. Half of a bucket's limit is moved on each refill or flush.
+  static constexpr size_t kMaxBytesPerBucket = 4096;
+  static constexpr uint16_t kMaxCountPerBucket = 128;
+  static constexpr uint16_t kMinCountPerBucket = 8;
+
+  ~ThreadCache();
+
+  // Returns a slot of the bucket at |bucket_index|, or nullptr if the cache is
+  // empty for this bucket and the central bucket couldn't provide one either.
+  // The returned pointer is the start of the slot, before cookie adjustment.
+  ALWAYS_INLINE void* GetFromCache(size_t bucket_index);
+
+  // Puts the slot at |slot_start| in the cache. |bucket_index| must be the
+  // index of the slot's bucket in its root.
+  ALWAYS_INLINE void PutInCache(void* slot_start, size_t bucket_index);
+
+  // Returns all the cached slots to the central buckets. Takes the root lock.
+  void Purge();
+
+  size_t cached_bytes() const { return cached_bytes_; }
+
+ private:
+  friend class ThreadCacheRegistry;
+
+  struct Bucket {
+    PartitionFreelistEntry* freelist_head;
+    uint16_t count;
+    uint16_t limit;
+    uint32_t slot_size;
+  };
+
+  ThreadCache(PartitionRootGeneric* root, ThreadCacheRegistry* registry);
+
+  NOINLINE void* GetFromCacheSlowPath(size_t bucket_index);
+  NOINLINE void FlushBucket(Bucket* bucket, uint16_t count_to_keep);
+  NOINLINE void PurgeIfRequested();
+
+  PartitionRootGeneric* const root_;
+  ThreadCacheRegistry* const registry_;
+  Bucket buckets_[kNumBuckets];
+  size_t cached_bytes_ = 0;
+  std::atomic<bool> should_purge_{false};
+
+  // Intrusive list of the caches of |registry_|, guarded by its lock.
+  ThreadCache* next_ = nullptr;
+  ThreadCache* prev_ = nullptr;
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadCache);
+};
+
+// Owns the ThreadCache instances of a partition, one per thread that allocates
+// from it. Caches are created lazily on the first cacheable allocation of a
+// thread and destroyed, after returning their slots, when the thread exits.
+class BASE_EXPORT ThreadCacheRegistry {
+ public:
+  explicit ThreadCacheRegistry(PartitionRootGeneric* root);
+  ~ThreadCacheRegistry();
+
+  // Returns the cache of the current thread, or nullptr if there is none.
+  ThreadCache* Get();
+  // Same as Get(), but creates the cache if there is none. May still return
+  // nullptr when the thread is being torn down.
+  ThreadCache* GetOrCreate();
+
+  // Purges the cache of the current thread right away, and asks every other
+  // thread to purge its own cache on its next free from this partition.
+  void PurgeAll();
+
+ private:
+  static void OnThreadExit(void* value);
+
+  void Register(ThreadCache* cache);
+  void Unregister(ThreadCache* cache);
+
+  PartitionRootGeneric* const root_;
+  ThreadLocalStorage::Slot slot_;
+  subtle::SpinLock lock_;
+  ThreadCache* head_ = nullptr;
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadCacheRegistry);
+};
+
+ALWAYS_INLINE void* ThreadCache::GetFromCache(size_t bucket_index) {
+  DCHECK(bucket_index < kNumBuckets);
+  Bucket& bucket = buckets_[bucket_index];
+  PartitionFreelistEntry* entry = bucket.freelist_head;
+  if (UNLIKELY(!entry))
+    return GetFromCacheSlowPath(bucket_index);
+
+  bucket.freelist_head = EncodedPartitionFreelistEntry::Decode(entry->next);
+  bucket.count--;
+  cached_bytes_ -= bucket.slot_size;
+  return entry;
+}
+
+ALWAYS_INLINE void ThreadCache::PutInCache(void* slot_start,
+                                           size_t bucket_index) {
+  DCHECK(bucket_index < kNumBuckets);
+  Bucket& bucket = buckets_[bucket_index];
+#if DCHECK_IS_ON()
+  // Same checks as PartitionPage::Free(), since this is where the slot is
+  // freed as far as the caller is concerned.
+  PartitionCookieCheckValue(slot_start);
+  PartitionCookieCheckValue(reinterpret_cast<char*>(slot_start) +
+                            bucket.slot_size - kCookieSize);
+  memset(slot_start, kFreedByte, bucket.slot_size);
+#endif
+  // Catches an immediate double free.
+  CHECK(slot_start != bucket.freelist_head);
+  auto* entry = static_cast<PartitionFreelistEntry*>(slot_start);
+  entry->next = PartitionFreelistEntry::Encode(bucket.freelist_head);
+  bucket.freelist_head = entry;
+  bucket.count++;
+  cached_bytes_ += bucket.slot_size;
+
+  if (UNLIKELY(bucket.count > bucket.limit))
+    FlushBucket(&bucket, bucket.limit / 2);
+  if (UNLIKELY(should_purge_.load(std::memory_order_relaxed)))
+    PurgeIfRequested();
+}
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_ALLOCATOR_PARTITION_ALLOCATOR_THREAD_CACHE_H_
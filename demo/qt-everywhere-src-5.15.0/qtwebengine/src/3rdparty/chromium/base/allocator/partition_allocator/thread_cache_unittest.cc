@@ -0,0 +1,136 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/allocator/partition_allocator/thread_cache.h"
+
+#include <vector>
+
+#include "base/allocator/partition_allocator/partition_alloc.h"
+#include "base/threading/platform_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// Otherwise, PartitionAlloc doesn't allocate any memory, and the tests are
+// meaningless.
+#if !defined(MEMORY_TOOL_REPLACES_ALLOCATOR)
+
+namespace base {
+namespace internal {
+
+namespace {
+
+constexpr size_t kSmallSize = 12;
+constexpr size_t kLargeSize = ThreadCache::kMaxCachedSlotSize + 1;
+
+class ThreadCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    allocator_.init();
+    allocator_.root()->EnableThreadCache();
+  }
+
+  void TearDown() override {
+    allocator_.root()->PurgeMemory(PartitionPurgeDecommitEmptyPages |
+                                   PartitionPurgeDiscardUnusedSystemPages);
+  }
+
+  PartitionRootGeneric* root() { return allocator_.root(); }
+
+  ThreadCache* thread_cache() { return root()->thread_caches->Get(); }
+
+  PartitionAllocatorGeneric allocator_;
+};
+
+class AllocAndFreeThread : public PlatformThread::Delegate {
+ public:
+  explicit AllocAndFreeThread(PartitionRootGeneric* root) : root_(root) {}
+
+  void ThreadMain() override {
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 1000; ++i)
+      ptrs.push_back(root_->Alloc(kSmallSize, ""));
+    for (void* ptr : ptrs)
+      root_->Free(ptr);
+    had_cache_ = root_->thread_caches->Get() != nullptr;
+  }
+
+  bool had_cache() const { return had_cache_; }
+
+ private:
+  PartitionRootGeneric* root_;
+  bool had_cache_ = false;
+};
+
+}  // namespace
+
+TEST_F(ThreadCacheTest, CreatedOnFirstSmallAlloc) {
+  EXPECT_FALSE(thread_cache());
+
+  void* large = root()->Alloc(kLargeSize, "");
+  EXPECT_FALSE(thread_cache());
+  root()->Free(large);
+  EXPECT_FALSE(thread_cache());
+
+  void* small = root()->Alloc(kSmallSize, "");
+  ASSERT_TRUE(thread_cache());
+  root()->Free(small);
+}
+
+TEST_F(ThreadCacheTest, FreedSlotIsReused) {
+  void* first = root()->Alloc(kSmallSize, "");
+  root()->Free(first);
+  size_t cached_bytes = thread_cache()->cached_bytes();
+  EXPECT_GT(cached_bytes, 0u);
+
+  void* second = root()->Alloc(kSmallSize, "");
+  EXPECT_EQ(first, second);
+  EXPECT_LT(thread_cache()->cached_bytes(), cached_bytes);
+  root()->Free(second);
+}
+
+TEST_F(ThreadCacheTest, CachedBytesAreBounded) {
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 10000; ++i)
+    ptrs.push_back(root()->Alloc(kSmallSize, ""));
+  for (void* ptr : ptrs)
+    root()->Free(ptr);
+
+  EXPECT_LE(thread_cache()->cached_bytes(), ThreadCache::kMaxBytesPerBucket +
+                                                ThreadCache::kMaxCachedSlotSize);
+}
+
+TEST_F(ThreadCacheTest, PurgeReturnsSlots) {
+  void* ptr = root()->Alloc(kSmallSize, "");
+  root()->Free(ptr);
+  EXPECT_GT(thread_cache()->cached_bytes(), 0u);
+
+  size_t committed_before = root()->total_size_of_committed_pages;
+  root()->PurgeMemory(PartitionPurgeDecommitEmptyPages);
+  EXPECT_EQ(0u, thread_cache()->cached_bytes());
+  // With nothing else allocated, the slot span is empty and decommitted.
+  EXPECT_LT(root()->total_size_of_committed_pages, committed_before);
+}
+
+TEST_F(ThreadCacheTest, ThreadExitReturnsSlots) {
+  AllocAndFreeThread delegate(root());
+  PlatformThreadHandle handle;
+  ASSERT_TRUE(PlatformThread::Create(0, &delegate, &handle));
+  PlatformThread::Join(handle);
+  EXPECT_TRUE(delegate.had_cache());
+
+  // The slots cached by the other thread went back to their pages, which are
+  // all empty now.
+  PartitionBucket* bucket = PartitionGenericSizeToBucket(
+      root(), PartitionCookieSizeAdjustAdd(kSmallSize));
+  EXPECT_FALSE(bucket->num_full_pages);
+  for (PartitionPage* page = bucket->active_pages_head;
+       page && page != PartitionPage::get_sentinel_page();
+       page = page->next_page) {
+    EXPECT_EQ(0, page->num_allocated_slots);
+  }
+}
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // !defined(MEMORY_TOOL_REPLACES_ALLOCATOR)
@@ -17,6 +17,9 @@ const Feature kNoDetachBelowInitialCapacity = {
 const Feature kMayBlockWithoutDelay = {"MayBlockWithoutDelay",
                                        base::FEATURE_DISABLED_BY_DEFAULT};
 
+const Feature kBatchedWorkerWakeUps = {"BatchedWorkerWakeUps",
+                                       base::FEATURE_DISABLED_BY_DEFAULT};
+
 #if defined(OS_WIN) || defined(OS_MACOSX)
 const Feature kUseNativeThreadPool = {"UseNativeThreadPool",
                                       base::FEATURE_DISABLED_BY_DEFAULT};
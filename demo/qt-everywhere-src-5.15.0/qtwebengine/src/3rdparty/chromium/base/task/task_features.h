@@ -23,6 +23,11 @@ extern const BASE_EXPORT Feature kNoDetachBelowInitialCapacity;
 // instead of waiting for a threshold in the foreground thread group.
 extern const BASE_EXPORT Feature kMayBlockWithoutDelay;
 
+// Under this feature, a ThreadGroupImpl wakes up all the workers needed to run
+// its queued task sources at once, instead of waking up at most two and
+// letting each awoken worker wake up the next ones.
+extern const BASE_EXPORT Feature kBatchedWorkerWakeUps;
+
 #if defined(OS_WIN) || defined(OS_MACOSX)
 #define HAS_NATIVE_THREAD_POOL() 1
 #else
@@ -390,6 +390,7 @@ void ThreadGroupImpl::Start(
   in_start().may_block_without_delay =
       FeatureList::IsEnabled(kMayBlockWithoutDelay) &&
       priority_hint_ == ThreadPriority::NORMAL;
+  in_start().batched_wake_ups = FeatureList::IsEnabled(kBatchedWorkerWakeUps);
   in_start().may_block_threshold =
       may_block_threshold ? may_block_threshold.value()
                           : (priority_hint_ == ThreadPriority::NORMAL
@@ -1027,7 +1028,13 @@ void ThreadGroupImpl::EnsureEnoughWorkersLockRequired(
 
   size_t num_workers_to_wake_up =
       ClampSub(desired_num_awake_workers, num_awake_workers);
-  num_workers_to_wake_up = std::min(num_workers_to_wake_up, size_t(2U));
+  // By default, wake-ups are chained: each awoken worker calls this again when
+  // it gets work, which wakes up the next ones. This avoids waking up workers
+  // that would find no work once the first ones have run, at the cost of
+  // latency when a burst of task sources is posted. The wake-ups scheduled
+  // below are all performed by |executor| once |lock_| is released.
+  if (!after_start().batched_wake_ups)
+    num_workers_to_wake_up = std::min(num_workers_to_wake_up, size_t(2U));
 
   // Wake up the appropriate number of workers.
   for (size_t i = 0; i < num_workers_to_wake_up; ++i) {
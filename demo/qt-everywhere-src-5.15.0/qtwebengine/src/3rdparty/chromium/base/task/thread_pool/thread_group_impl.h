@@ -246,6 +246,10 @@ class BASE_EXPORT ThreadGroupImpl : public ThreadGroup {
 
     bool may_block_without_delay;
 
+    // Whether all the workers needed are woken up at once. See
+    // kBatchedWorkerWakeUps.
+    bool batched_wake_ups;
+
     // Threshold after which the max tasks is increased to compensate for a
     // worker that is within a MAY_BLOCK ScopedBlockingCall.
     TimeDelta may_block_threshold;
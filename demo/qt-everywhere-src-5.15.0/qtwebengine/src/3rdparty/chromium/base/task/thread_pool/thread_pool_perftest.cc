@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include <stddef.h>
+#include <algorithm>
 #include <atomic>
 #include <memory>
 #include <vector>
@@ -12,9 +13,12 @@
 #include "base/bind_helpers.h"
 #include "base/callback.h"
 #include "base/optional.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/task/post_task.h"
+#include "base/task/task_features.h"
 #include "base/task/thread_pool/thread_pool_instance.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/threading/simple_thread.h"
 #include "base/time/time.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -94,6 +98,19 @@ class ThreadPoolPerfTest : public testing::Test {
     }
   }
 
+  // Posts no-op tasks which record the time elapsed between their posting and
+  // their execution. RecordTaskLatencies() must have been called first.
+  void ContinuouslyPostTimedNoOpTasks(size_t num_tasks) {
+    scoped_refptr<TaskRunner> task_runner = CreateTaskRunner({ThreadPool()});
+    for (size_t i = 0; i < num_tasks; ++i) {
+      ++num_tasks_pending_;
+      ++num_posted_tasks_;
+      task_runner->PostTask(
+          FROM_HERE, base::BindOnce(&ThreadPoolPerfTest::OnTimedTaskRun,
+                                    Unretained(this), TimeTicks::Now()));
+    }
+  }
+
   void ContinuouslyPostBusyWaitTasks(size_t num_tasks,
                                      base::TimeDelta duration) {
     scoped_refptr<TaskRunner> task_runner = CreateTaskRunner({ThreadPool()});
@@ -135,6 +152,19 @@ class ThreadPoolPerfTest : public testing::Test {
 
   void OnCompletePostingTasks() { complete_posting_tasks_.Signal(); }
 
+  // Makes Benchmark() report percentiles of the latency of up to |max_tasks|
+  // tasks posted with ContinuouslyPostTimedNoOpTasks().
+  void RecordTaskLatencies(size_t max_tasks) {
+    task_latencies_.resize(max_tasks);
+  }
+
+  void OnTimedTaskRun(TimeTicks posted_time) {
+    const size_t index = num_recorded_latencies_++;
+    CHECK_LT(index, task_latencies_.size());
+    task_latencies_[index] = TimeTicks::Now() - posted_time;
+    num_tasks_pending_--;
+  }
+
   void Benchmark(const std::string& trace, ExecutionMode execution_mode) {
     base::Optional<ThreadPoolInstance::ScopedExecutionFence> execution_fence;
     if (execution_mode == ExecutionMode::kPostThenRun) {
@@ -171,6 +201,18 @@ class ThreadPoolPerfTest : public testing::Test {
         "tasks/ms", true);
     perf_test::PrintResult("Num tasks posted", "", trace, num_posted_tasks_,
                            "tasks", true);
+
+    if (num_recorded_latencies_ == 0)
+      return;
+    DCHECK_EQ(num_posted_tasks_, num_recorded_latencies_);
+    task_latencies_.resize(num_recorded_latencies_);
+    std::sort(task_latencies_.begin(), task_latencies_.end());
+    for (size_t percentile : {50, 90, 99}) {
+      const size_t index = (task_latencies_.size() - 1) * percentile / 100;
+      perf_test::PrintResult(
+          "Task latency", " p" + NumberToString(percentile), trace,
+          task_latencies_[index].InMicrosecondsF(), "us", true);
+    }
   }
 
  private:
@@ -183,6 +225,9 @@ class ThreadPoolPerfTest : public testing::Test {
   std::atomic_size_t num_tasks_pending_{0};
   std::atomic_size_t num_posted_tasks_{0};
 
+  std::vector<TimeDelta> task_latencies_;
+  std::atomic_size_t num_recorded_latencies_{0};
+
   std::vector<std::unique_ptr<PostingThread>> threads_;
 
   DISALLOW_COPY_AND_ASSIGN(ThreadPoolPerfTest);
@@ -244,5 +289,27 @@ TEST_F(ThreadPoolPerfTest, PostRunBusyTasksManyThreads) {
   Benchmark("Post/run busy tasks many threads", ExecutionMode::kPostAndRun);
 }
 
+TEST_F(ThreadPoolPerfTest, PostRunNoOpTasksManyThreadsLatency) {
+  RecordTaskLatencies(4 * 10000);
+  StartThreadPool(
+      4, 4,
+      BindRepeating(&ThreadPoolPerfTest::ContinuouslyPostTimedNoOpTasks,
+                    Unretained(this), 10000));
+  Benchmark("Post/run no-op tasks many threads latency",
+            ExecutionMode::kPostAndRun);
+}
+
+TEST_F(ThreadPoolPerfTest, PostRunNoOpTasksManyThreadsLatencyBatchedWakeUps) {
+  test::ScopedFeatureList feature_list;
+  feature_list.InitAndEnableFeature(kBatchedWorkerWakeUps);
+  RecordTaskLatencies(4 * 10000);
+  StartThreadPool(
+      4, 4,
+      BindRepeating(&ThreadPoolPerfTest::ContinuouslyPostTimedNoOpTasks,
+                    Unretained(this), 10000));
+  Benchmark("Post/run no-op tasks many threads latency batched wake-ups",
+            ExecutionMode::kPostAndRun);
+}
+
 }  // namespace internal
 }  // namespace base
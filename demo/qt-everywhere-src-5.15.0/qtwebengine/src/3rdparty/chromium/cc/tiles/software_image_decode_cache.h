@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -14,7 +15,6 @@
 #include "base/containers/mru_cache.h"
 #include "base/memory/memory_pressure_listener.h"
 #include "base/memory/ref_counted.h"
-#include "base/numerics/safe_math.h"
 #include "base/thread_annotations.h"
 #include "base/trace_event/memory_dump_provider.h"
 #include "cc/cc_export.h"
@@ -79,14 +79,20 @@ class CC_EXPORT SoftwareImageDecodeCache
  private:
   using CacheEntry = Utils::CacheEntry;
 
+  // The number of shards the cache entries are split across. See Shard.
+  static constexpr size_t kNumShards = 8;
+
   // MemoryBudget is a convenience class for memory bookkeeping and ensuring
-  // that we don't go over the limit when pre-decoding.
+  // that we don't go over the limit when pre-decoding. It is shared by all the
+  // shards, and is thread safe.
   class MemoryBudget {
    public:
     explicit MemoryBudget(size_t limit_bytes);
 
     size_t AvailableMemoryBytes() const;
-    void AddUsage(size_t usage);
+    // Adds |usage| to the current usage if that doesn't go over the limit.
+    // Returns whether the usage was added.
+    bool TryAddUsage(size_t usage);
     void SubtractUsage(size_t usage);
     void ResetUsage();
     size_t total_limit_bytes() const { return limit_bytes_; }
@@ -94,67 +100,88 @@ class CC_EXPORT SoftwareImageDecodeCache
 
    private:
     const size_t limit_bytes_;
-    base::CheckedNumeric<size_t> current_usage_bytes_;
+    std::atomic<size_t> current_usage_bytes_;
   };
 
   using ImageMRUCache = base::
       HashingMRUCache<CacheKey, std::unique_ptr<CacheEntry>, CacheKeyHash>;
 
+  // A subset of the cache entries, with its own lock. Entries are assigned to
+  // shards by the frame key of their image, so that raster workers decoding
+  // different images don't contend on a single lock. All the decodes of an
+  // image are in the same shard, which lets FindCachedCandidate() and the
+  // scaled decode path stay within a single shard.
+  struct Shard {
+    Shard();
+    ~Shard();
+
+    base::Lock lock;
+    // Decoded images and ref counts (predecode path).
+    ImageMRUCache decoded_images GUARDED_BY(lock);
+
+    // A map of PaintImage::FrameKey to the ImageKeys for cached decodes of
+    // this PaintImage.
+    std::unordered_map<PaintImage::FrameKey,
+                       std::vector<CacheKey>,
+                       PaintImage::FrameKeyHash>
+        frame_key_to_image_keys GUARDED_BY(lock);
+  };
+
+  Shard* GetShard(const CacheKey& key);
+
   // Get the decoded draw image for the given key and paint_image. Note that
   // when used internally, we still require that DrawWithImageFinished() is
   // called afterwards.
-  DecodedDrawImage GetDecodedImageForDrawInternal(const CacheKey& key,
+  DecodedDrawImage GetDecodedImageForDrawInternal(Shard* shard,
+                                                  const CacheKey& key,
                                                   const PaintImage& paint_image)
-      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+      EXCLUSIVE_LOCKS_REQUIRED(shard->lock);
+
+  // Removes unlocked decoded images until the number of decoded images in
+  // |shard| is reduced within the given limit.
+  void ReduceCacheUsageUntilWithinLimit(Shard* shard, size_t limit)
+      EXCLUSIVE_LOCKS_REQUIRED(shard->lock);
 
-  // Removes unlocked decoded images until the number of decoded images is
-  // reduced within the given limit.
-  void ReduceCacheUsageUntilWithinLimit(size_t limit)
-      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  // Same as above, for every shard. |limit| applies to the whole cache.
+  void ReduceAllCacheUsageUntilWithinLimit(size_t limit);
 
-  void OnMemoryPressure(base::MemoryPressureListener::MemoryPressureLevel level)
-      LOCKS_EXCLUDED(lock_);
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
 
   // Helper method to get the different tasks. Note that this should be used as
   // if it was public (ie, all of the locks need to be properly acquired).
   TaskResult GetTaskForImageAndRefInternal(const DrawImage& image,
                                            const TracingInfo& tracing_info,
-                                           DecodeTaskType type)
-      LOCKS_EXCLUDED(lock_);
+                                           DecodeTaskType type);
 
-  CacheEntry* AddCacheEntry(const CacheKey& key)
-      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  CacheEntry* AddCacheEntry(Shard* shard, const CacheKey& key)
+      EXCLUSIVE_LOCKS_REQUIRED(shard->lock);
 
-  TaskProcessingResult DecodeImageIfNecessary(const CacheKey& key,
+  TaskProcessingResult DecodeImageIfNecessary(Shard* shard,
+                                              const CacheKey& key,
                                               const PaintImage& paint_image,
                                               CacheEntry* cache_entry)
-      EXCLUSIVE_LOCKS_REQUIRED(lock_);
-  void AddBudgetForImage(const CacheKey& key, CacheEntry* entry)
-      EXCLUSIVE_LOCKS_REQUIRED(lock_);
-  void RemoveBudgetForImage(const CacheKey& key, CacheEntry* entry)
-      EXCLUSIVE_LOCKS_REQUIRED(lock_);
-  base::Optional<CacheKey> FindCachedCandidate(const CacheKey& key)
-      EXCLUSIVE_LOCKS_REQUIRED(lock_);
-
-  void UnrefImage(const CacheKey& key) EXCLUSIVE_LOCKS_REQUIRED(lock_);
-
-  base::Lock lock_;
-  // Decoded images and ref counts (predecode path).
-  ImageMRUCache decoded_images_ GUARDED_BY(lock_);
-
-  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_
-      GUARDED_BY(lock_);
-
-  // A map of PaintImage::FrameKey to the ImageKeys for cached decodes of this
-  // PaintImage.
-  std::unordered_map<PaintImage::FrameKey,
-                     std::vector<CacheKey>,
-                     PaintImage::FrameKeyHash>
-      frame_key_to_image_keys_ GUARDED_BY(lock_);
-
-  // Should be GUARDED_BY(lock_), except that accessing
-  // |locked_images_budget_.total_limit_bytes()| is fine without the lock, as
-  // it is const and thread safe.
+      EXCLUSIVE_LOCKS_REQUIRED(shard->lock);
+  // Returns false if the image doesn't fit in the remaining budget.
+  bool AddBudgetForImage(Shard* shard, const CacheKey& key, CacheEntry* entry)
+      EXCLUSIVE_LOCKS_REQUIRED(shard->lock);
+  void RemoveBudgetForImage(Shard* shard,
+                            const CacheKey& key,
+                            CacheEntry* entry)
+      EXCLUSIVE_LOCKS_REQUIRED(shard->lock);
+  base::Optional<CacheKey> FindCachedCandidate(Shard* shard,
+                                               const CacheKey& key)
+      EXCLUSIVE_LOCKS_REQUIRED(shard->lock);
+
+  void UnrefImage(Shard* shard, const CacheKey& key)
+      EXCLUSIVE_LOCKS_REQUIRED(shard->lock);
+
+  Shard shards_[kNumShards];
+
+  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+
+  // Shared by all the shards, so that a few large images are not limited to
+  // the budget of a single shard.
   MemoryBudget locked_images_budget_;
 
   const SkColorType color_type_;
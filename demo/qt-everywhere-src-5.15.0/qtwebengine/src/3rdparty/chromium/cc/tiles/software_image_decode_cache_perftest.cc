@@ -2,12 +2,18 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <atomic>
+#include <memory>
+#include <utility>
 #include <vector>
 
+#include "base/strings/string_number_conversions.h"
+#include "base/threading/platform_thread.h"
 #include "base/timer/lap_timer.h"
 #include "cc/paint/draw_image.h"
 #include "cc/paint/paint_image_builder.h"
 #include "cc/raster/tile_task.h"
+#include "cc/test/skia_common.h"
 #include "cc/tiles/software_image_decode_cache.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/perf/perf_result_reporter.h"
@@ -18,6 +24,7 @@ namespace {
 static const int kTimeLimitMillis = 2000;
 static const int kWarmupRuns = 5;
 static const int kTimeCheckInterval = 10;
+static const int kImagesPerRasterThread = 32;
 
 sk_sp<SkImage> CreateImage(int width, int height) {
   SkBitmap bitmap;
@@ -31,6 +38,50 @@ SkMatrix CreateMatrix(const SkSize& scale) {
   return matrix;
 }
 
+std::vector<DrawImage> CreateDecodedImages(SoftwareImageDecodeCache* cache) {
+  std::vector<DrawImage> images;
+  for (int i = 0; i < kImagesPerRasterThread; ++i) {
+    images.emplace_back(CreateDiscardablePaintImage(gfx::Size(64, 64)),
+                        SkIRect::MakeWH(64, 64), kMedium_SkFilterQuality,
+                        CreateMatrix(SkSize::Make(0.5f, 0.5f)), 0u,
+                        gfx::ColorSpace::CreateSRGB());
+    DecodedDrawImage decoded_image =
+        cache->GetDecodedImageForDraw(images.back());
+    cache->DrawWithImageFinished(images.back(), decoded_image);
+  }
+  return images;
+}
+
+// Draws its images from |cache| in a loop until destroyed, as a raster worker
+// would when rastering tiles which reference already decoded images.
+class RasterThread : public base::PlatformThread::Delegate {
+ public:
+  RasterThread(SoftwareImageDecodeCache* cache, std::vector<DrawImage> images)
+      : cache_(cache), images_(std::move(images)), should_stop_(false) {
+    base::PlatformThread::Create(0, this, &thread_handle_);
+  }
+
+  ~RasterThread() override {
+    should_stop_ = true;
+    base::PlatformThread::Join(thread_handle_);
+  }
+
+  void ThreadMain() override {
+    while (!should_stop_) {
+      for (const auto& image : images_) {
+        DecodedDrawImage decoded_image = cache_->GetDecodedImageForDraw(image);
+        cache_->DrawWithImageFinished(image, decoded_image);
+      }
+    }
+  }
+
+ private:
+  SoftwareImageDecodeCache* cache_;
+  const std::vector<DrawImage> images_;
+  std::atomic<bool> should_stop_;
+  base::PlatformThreadHandle thread_handle_;
+};
+
 class SoftwareImageDecodeCachePerfTest : public testing::Test {
  public:
   SoftwareImageDecodeCachePerfTest()
@@ -84,6 +135,36 @@ class SoftwareImageDecodeCachePerfTest : public testing::Test {
     reporter.AddResult("", timer_.LapsPerSecond());
   }
 
+  // Draws decoded images from a cache shared with |thread_count| - 1 other
+  // raster threads drawing their own images, and reports the draws per second
+  // of this thread. The images are decoded up front, so that only the cache
+  // itself is measured.
+  void RunDrawWithRasterThreads(int thread_count) {
+    SoftwareImageDecodeCache cache(kN32_SkColorType, 256 * 1024 * 1024,
+                                   PaintImage::kDefaultGeneratorClientId);
+    std::vector<std::unique_ptr<RasterThread>> threads;
+    for (int i = 1; i < thread_count; ++i)
+      threads.push_back(
+          std::make_unique<RasterThread>(&cache, CreateDecodedImages(&cache)));
+    std::vector<DrawImage> images = CreateDecodedImages(&cache);
+
+    timer_.Reset();
+    do {
+      for (const auto& image : images) {
+        DecodedDrawImage decoded_image = cache.GetDecodedImageForDraw(image);
+        cache.DrawWithImageFinished(image, decoded_image);
+      }
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+    threads.clear();
+
+    perf_test::PerfResultReporter reporter(
+        "software_image_decode_cache",
+        "draw_" + base::NumberToString(thread_count) + "_raster_threads");
+    reporter.RegisterImportantMetric("", "runs/s");
+    reporter.AddResult("", timer_.LapsPerSecond() * images.size());
+  }
+
  private:
   base::LapTimer timer_;
 };
@@ -92,5 +173,10 @@ TEST_F(SoftwareImageDecodeCachePerfTest, FromDrawImage) {
   RunFromImage();
 }
 
+TEST_F(SoftwareImageDecodeCachePerfTest, DrawWithRasterThreads) {
+  for (int thread_count : {1, 2, 4, 8})
+    RunDrawWithRasterThreads(thread_count);
+}
+
 }  // namespace
 }  // namespace cc
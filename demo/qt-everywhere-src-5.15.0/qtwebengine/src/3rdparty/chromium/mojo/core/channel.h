@@ -74,6 +74,12 @@ class MOJO_SYSTEM_IMPL_EXPORT Channel
 #endif
       // A normal message that uses Header and can contain extra header values.
       NORMAL,
+      // A control message carrying a shared memory region which holds a large
+      // serialized message. Only sent by ChannelPosix.
+      LARGE_MESSAGE,
+      // A control message telling the sender of a LARGE_MESSAGE that its
+      // region can be reused.
+      LARGE_MESSAGE_ACK,
     };
 
 #pragma pack(push, 1)
@@ -319,6 +325,7 @@ class MOJO_SYSTEM_IMPL_EXPORT Channel
   virtual ~Channel();
 
   Delegate* delegate() const { return delegate_; }
+  HandlePolicy handle_policy() const { return handle_policy_; }
 
   // Called by the implementation when it wants somewhere to stick data.
   // |*buffer_capacity| may be set by the caller to indicate the desired buffer
@@ -21,11 +21,20 @@
 #include "base/synchronization/lock.h"
 #include "base/task_runner.h"
 #include "build/build_config.h"
+#include "mojo/core/configuration.h"
 #include "mojo/core/core.h"
 #include "mojo/public/cpp/platform/socket_utils_posix.h"
 
 #if !defined(OS_NACL)
+#include <sys/stat.h>
 #include <sys/uio.h>
+
+#include "base/bits.h"
+#include "base/memory/aligned_memory.h"
+#include "base/memory/shared_memory_mapping.h"
+#include "base/memory/unsafe_shared_memory_region.h"
+#include "base/unguessable_token.h"
+#include "mojo/core/platform_handle_utils.h"
 #endif
 
 namespace mojo {
@@ -35,6 +44,45 @@ namespace {
 
 const size_t kMaxBatchReadCapacity = 256 * 1024;
 
+#if !defined(OS_NACL) && !defined(OS_IOS)
+// Messages of at least this many bytes are copied into a shared memory region
+// and only a small LARGE_MESSAGE control message is written to the socket, so
+// the payload doesn't need to be pushed through the socket buffer in chunks.
+const size_t kMinLargeMessageSize = 64 * 1024;
+
+// Maximum total size of the shared memory regions kept by a channel for large
+// messages. Larger messages, or messages sent while the pool is exhausted, go
+// through the socket.
+const size_t kMaxLargeMessagePoolSize = 16 * 1024 * 1024;
+
+#pragma pack(push, 1)
+// Payload of a LARGE_MESSAGE control message. The message has a single handle,
+// for the region, but the handles attached to the wrapped message are sent
+// along with it and picked up when the wrapped message is dispatched.
+struct LargeMessageHeader {
+  uint64_t region_id;
+  uint64_t region_num_bytes;
+  uint64_t guid_high;
+  uint64_t guid_low;
+  uint32_t message_num_bytes;
+  uint32_t padding;
+};
+
+// Payload of a LARGE_MESSAGE_ACK control message.
+struct LargeMessageAck {
+  uint64_t region_id;
+};
+#pragma pack(pop)
+
+// A shared memory region owned by the sending side of a channel.
+struct LargeMessageRegion {
+  uint64_t id = 0;
+  base::UnsafeSharedMemoryRegion region;
+  base::WritableSharedMemoryMapping mapping;
+  bool in_use = false;
+};
+#endif  // !defined(OS_NACL) && !defined(OS_IOS)
+
 // A view over a Channel::Message object. The write queue uses these since
 // large messages may need to be sent in chunks.
 class MessageView {
@@ -132,10 +180,11 @@ class ChannelPosix : public Channel,
       if (reject_writes_)
         return;
       if (outgoing_messages_.empty()) {
-        if (!WriteNoLock(MessageView(std::move(message), 0)))
+        if (!WriteNoLock(CreateMessageViewNoLock(std::move(message))))
           reject_writes_ = write_error = true;
       } else {
-        outgoing_messages_.emplace_back(std::move(message), 0);
+        outgoing_messages_.push_back(
+            CreateMessageViewNoLock(std::move(message)));
       }
     }
     if (write_error) {
@@ -330,6 +379,202 @@ class ChannelPosix : public Channel,
       OnWriteError(Error::kDisconnected);
   }
 
+#if !defined(OS_NACL) && !defined(OS_IOS)
+  // Wraps |message| in a LARGE_MESSAGE control message if it is large enough
+  // and a shared memory region is available for it.
+  MessageView CreateMessageViewNoLock(MessagePtr message) {
+    if (large_messages_unsupported_ ||
+        handle_policy() != HandlePolicy::kAcceptHandles ||
+        message->data_num_bytes() < kMinLargeMessageSize ||
+        message->num_handles() + 1 > kMaxSendmsgHandles) {
+      return MessageView(std::move(message), 0);
+    }
+
+    LargeMessageRegion* region =
+        AcquireLargeMessageRegionNoLock(message->data_num_bytes());
+    if (!region)
+      return MessageView(std::move(message), 0);
+    base::UnsafeSharedMemoryRegion region_to_send = region->region.Duplicate();
+    if (!region_to_send.IsValid())
+      return MessageView(std::move(message), 0);
+
+    memcpy(region->mapping.memory(), message->data(),
+           message->data_num_bytes());
+    region->in_use = true;
+
+    MessagePtr large_message = std::make_unique<Channel::Message>(
+        sizeof(LargeMessageHeader), 1, Message::MessageType::LARGE_MESSAGE);
+    auto* header =
+        static_cast<LargeMessageHeader*>(large_message->mutable_payload());
+    header->region_id = region->id;
+    header->region_num_bytes = region_to_send.GetSize();
+    header->guid_high = region_to_send.GetGUID().GetHighForSerialization();
+    header->guid_low = region_to_send.GetGUID().GetLowForSerialization();
+    header->message_num_bytes =
+        static_cast<uint32_t>(message->data_num_bytes());
+    header->padding = 0;
+
+    PlatformHandle region_handle;
+    PlatformHandle unused_readonly_handle;
+    ExtractPlatformHandlesFromSharedMemoryRegionHandle(
+        base::UnsafeSharedMemoryRegion::TakeHandleForSerialization(
+            std::move(region_to_send))
+            .PassPlatformHandle(),
+        &region_handle, &unused_readonly_handle);
+    std::vector<PlatformHandle> handles;
+    handles.push_back(std::move(region_handle));
+    large_message->SetHandles(std::move(handles));
+
+    // The wrapped message's handles follow the region handle on the wire.
+    std::vector<PlatformHandleInTransit> message_handles =
+        message->TakeHandles();
+    MessageView message_view(std::move(large_message), 0);
+    std::vector<PlatformHandleInTransit> all_handles =
+        message_view.TakeHandles();
+    for (auto& handle : message_handles)
+      all_handles.push_back(std::move(handle));
+    message_view.SetHandles(std::move(all_handles));
+    return message_view;
+  }
+
+  // Returns the smallest idle region which can hold |num_bytes|, creating one
+  // if necessary. Returns null if the pool is exhausted.
+  LargeMessageRegion* AcquireLargeMessageRegionNoLock(size_t num_bytes) {
+    LargeMessageRegion* best_region = nullptr;
+    for (auto& region : large_message_regions_) {
+      if (region.in_use || region.region.GetSize() < num_bytes)
+        continue;
+      if (!best_region ||
+          region.region.GetSize() < best_region->region.GetSize()) {
+        best_region = &region;
+      }
+    }
+    if (best_region)
+      return best_region;
+
+    const size_t region_size = size_t{1}
+                               << base::bits::Log2Ceiling(
+                                      static_cast<uint32_t>(num_bytes));
+    if (region_size > kMaxLargeMessagePoolSize)
+      return nullptr;
+
+    // Make room by dropping idle regions which are too small. The receiver
+    // doesn't keep mappings of them, so this needs no coordination.
+    while (large_message_pool_size_ + region_size > kMaxLargeMessagePoolSize) {
+      auto it = std::find_if(
+          large_message_regions_.begin(), large_message_regions_.end(),
+          [](const LargeMessageRegion& region) { return !region.in_use; });
+      if (it == large_message_regions_.end())
+        return nullptr;
+      large_message_pool_size_ -= it->region.GetSize();
+      large_message_regions_.erase(it);
+    }
+
+    LargeMessageRegion region;
+    region.region = base::UnsafeSharedMemoryRegion::Create(region_size);
+    if (region.region.IsValid())
+      region.mapping = region.region.Map();
+    if (!region.mapping.IsValid()) {
+      // Typically because this process is sandboxed. Don't try again.
+      large_messages_unsupported_ = true;
+      return nullptr;
+    }
+    region.id = next_large_message_region_id_++;
+    large_message_pool_size_ += region_size;
+    large_message_regions_.push_back(std::move(region));
+    return &large_message_regions_.back();
+  }
+
+  bool ReleaseLargeMessageRegion(uint64_t region_id) {
+    base::AutoLock lock(write_lock_);
+    for (auto& region : large_message_regions_) {
+      if (region.id == region_id && region.in_use) {
+        region.in_use = false;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Dispatches the message held in the region sent by a LARGE_MESSAGE, and
+  // acknowledges it once it has been dispatched.
+  bool DispatchLargeMessage(const LargeMessageHeader& header,
+                            PlatformHandle region_handle) {
+    // The header comes from the peer. Nothing is mapped or allocated for a
+    // message which TryDispatchMessage() would reject anyway.
+    if (header.region_num_bytes > std::numeric_limits<uint32_t>::max() ||
+        header.message_num_bytes < sizeof(Message::LegacyHeader) ||
+        header.message_num_bytes > header.region_num_bytes ||
+        header.message_num_bytes >
+            GetConfiguration().max_message_num_bytes) {
+      return false;
+    }
+
+#if !defined(OS_ANDROID)
+    // Mapping past the end of the file would SIGBUS on access, so the region
+    // must really be as large as the peer claims. Ashmem regions have their
+    // size checked when they are deserialized.
+    if (region_handle.is_fd()) {
+      struct stat region_stat;
+      if (fstat(region_handle.GetFD().get(), &region_stat) != 0 ||
+          region_stat.st_size < 0 ||
+          static_cast<uint64_t>(region_stat.st_size) <
+              header.region_num_bytes) {
+        return false;
+      }
+    }
+#endif
+
+    base::UnsafeSharedMemoryRegion region =
+        base::UnsafeSharedMemoryRegion::Deserialize(
+            base::subtle::PlatformSharedMemoryRegion::Take(
+                CreateSharedMemoryRegionHandleFromPlatformHandles(
+                    std::move(region_handle), PlatformHandle()),
+                base::subtle::PlatformSharedMemoryRegion::Mode::kUnsafe,
+                static_cast<size_t>(header.region_num_bytes),
+                base::UnguessableToken::Deserialize(header.guid_high,
+                                                    header.guid_low)));
+    if (!region.IsValid())
+      return false;
+    base::WritableSharedMemoryMapping mapping =
+        region.MapAt(0, header.message_num_bytes);
+    if (!mapping.IsValid())
+      return false;
+
+    // The sender can still write to the region, so the message is copied out
+    // before it is validated.
+    const size_t num_bytes = header.message_num_bytes;
+    std::unique_ptr<char, base::AlignedFreeDeleter> data(static_cast<char*>(
+        base::AlignedAlloc(num_bytes, kChannelMessageAlignment)));
+    memcpy(data.get(), mapping.memory(), num_bytes);
+    mapping = base::WritableSharedMemoryMapping();
+
+    const auto* legacy_header =
+        reinterpret_cast<const Message::LegacyHeader*>(data.get());
+    if (legacy_header->message_type != Message::MessageType::NORMAL_LEGACY &&
+        legacy_header->message_type != Message::MessageType::NORMAL) {
+      return false;
+    }
+    size_t size_hint = 0;
+    if (TryDispatchMessage(base::make_span(data.get(), num_bytes),
+                           &size_hint) != DispatchResult::kOK ||
+        size_hint != num_bytes) {
+      return false;
+    }
+
+    MessagePtr ack = std::make_unique<Channel::Message>(
+        sizeof(LargeMessageAck), 0, Message::MessageType::LARGE_MESSAGE_ACK);
+    static_cast<LargeMessageAck*>(ack->mutable_payload())->region_id =
+        header.region_id;
+    Write(std::move(ack));
+    return true;
+  }
+#else
+  MessageView CreateMessageViewNoLock(MessagePtr message) {
+    return MessageView(std::move(message), 0);
+  }
+#endif  // !defined(OS_NACL) && !defined(OS_IOS)
+
   // Attempts to write a message directly to the channel. If the full message
   // cannot be written, it's queued and a wait is initiated to write the message
   // ASAP on the I/O thread.
@@ -456,12 +701,13 @@ class ChannelPosix : public Channel,
     return true;
   }
 
-#if defined(OS_IOS)
+#if !defined(OS_NACL)
   bool OnControlMessage(Message::MessageType message_type,
                         const void* payload,
                         size_t payload_size,
                         std::vector<PlatformHandle> handles) override {
     switch (message_type) {
+#if defined(OS_IOS)
       case Message::MessageType::HANDLES_SENT: {
         if (payload_size == 0)
           break;
@@ -482,6 +728,25 @@ class ChannelPosix : public Channel,
           break;
         return true;
       }
+#else
+      case Message::MessageType::LARGE_MESSAGE: {
+        if (payload_size != sizeof(LargeMessageHeader) || handles.size() != 1)
+          break;
+        const auto* header = static_cast<const LargeMessageHeader*>(payload);
+        if (!DispatchLargeMessage(*header, std::move(handles[0])))
+          break;
+        return true;
+      }
+
+      case Message::MessageType::LARGE_MESSAGE_ACK: {
+        if (payload_size != sizeof(LargeMessageAck))
+          break;
+        const auto* ack = static_cast<const LargeMessageAck*>(payload);
+        if (!ReleaseLargeMessageRegion(ack->region_id))
+          break;
+        return true;
+      }
+#endif  // defined(OS_IOS)
 
       default:
         break;
@@ -489,7 +754,9 @@ class ChannelPosix : public Channel,
 
     return false;
   }
+#endif  // !defined(OS_NACL)
 
+#if defined(OS_IOS)
   // Closes handles referenced by |fds|. Returns false if |num_fds| is 0, or if
   // |fds| does not match a sequence of handles in |fds_to_close_|.
   bool CloseHandles(const int* fds, size_t num_fds) {
@@ -560,12 +827,22 @@ class ChannelPosix : public Channel,
 
   base::circular_deque<base::ScopedFD> incoming_fds_;
 
-  // Protects |pending_write_| and |outgoing_messages_|.
+  // Protects |pending_write_|, |outgoing_messages_| and the large message
+  // regions.
   base::Lock write_lock_;
   bool pending_write_ = false;
   bool reject_writes_ = false;
   base::circular_deque<MessageView> outgoing_messages_;
 
+#if !defined(OS_NACL) && !defined(OS_IOS)
+  // Regions used to send large messages. A region is in use from the time a
+  // message is copied into it until the peer acknowledges the message.
+  std::vector<LargeMessageRegion> large_message_regions_;
+  size_t large_message_pool_size_ = 0;
+  uint64_t next_large_message_region_id_ = 0;
+  bool large_messages_unsupported_ = false;
+#endif
+
   bool leak_handle_ = false;
 
 #if defined(OS_IOS)
@@ -5,9 +5,11 @@
 #include "mojo/core/channel.h"
 
 #include <atomic>
+#include <limits>
 
 #include "base/bind.h"
 #include "base/memory/ptr_util.h"
+#include "base/memory/unsafe_shared_memory_region.h"
 #include "base/message_loop/message_pump_type.h"
 #include "base/optional.h"
 #include "base/process/process_handle.h"
@@ -586,6 +588,188 @@ TEST(ChannelTest, MessageSizeTest) {
   }
 }
 
+#if defined(OS_POSIX) && !defined(OS_MACOSX) && !defined(OS_NACL)
+class LargeMessageDelegate : public Channel::Delegate {
+ public:
+  LargeMessageDelegate() = default;
+
+  void OnChannelMessage(const void* payload,
+                        size_t payload_size,
+                        std::vector<PlatformHandle> handles) override {
+    const char* bytes = static_cast<const char*>(payload);
+    payload_.assign(bytes, bytes + payload_size);
+    handles_ = std::move(handles);
+    run_loop_->Quit();
+  }
+
+  void OnChannelError(Channel::Error error) override {
+    channel_error_ = true;
+    if (run_loop_)
+      run_loop_->Quit();
+  }
+
+  void WaitForMessage() {
+    base::RunLoop loop;
+    run_loop_ = &loop;
+    loop.Run();
+    run_loop_ = nullptr;
+  }
+
+  const std::vector<char>& payload() const { return payload_; }
+  std::vector<PlatformHandle>& handles() { return handles_; }
+  bool channel_error() const { return channel_error_; }
+
+ private:
+  std::vector<char> payload_;
+  std::vector<PlatformHandle> handles_;
+  bool channel_error_ = false;
+  base::RunLoop* run_loop_ = nullptr;
+
+  DISALLOW_COPY_AND_ASSIGN(LargeMessageDelegate);
+};
+
+TEST(ChannelTest, LargeMessages) {
+  base::test::SingleThreadTaskEnvironment task_environment(
+      base::test::TaskEnvironment::MainThreadType::IO);
+  PlatformChannel platform_channel;
+
+  LargeMessageDelegate receiver_delegate;
+  scoped_refptr<Channel> receiver =
+      Channel::Create(&receiver_delegate,
+                      ConnectionParams(platform_channel.TakeLocalEndpoint()),
+                      Channel::HandlePolicy::kAcceptHandles,
+                      base::ThreadTaskRunnerHandle::Get());
+  receiver->Start();
+
+  LargeMessageDelegate sender_delegate;
+  scoped_refptr<Channel> sender = Channel::Create(
+      &sender_delegate, ConnectionParams(platform_channel.TakeRemoteEndpoint()),
+      Channel::HandlePolicy::kAcceptHandles,
+      base::ThreadTaskRunnerHandle::Get());
+  sender->Start();
+
+  // Sizes around the shared memory threshold, and one which is too large for
+  // the pool. Each size is sent twice so that regions get reused.
+  const size_t kSizes[] = {60 * 1024, 64 * 1024, 1024 * 1024,
+                           24 * 1024 * 1024};
+  for (size_t size : kSizes) {
+    for (int i = 0; i < 2; ++i) {
+      SCOPED_TRACE(base::StringPrintf("message size %zu", size));
+
+      PlatformChannel dummy_channel;
+      std::vector<PlatformHandle> handles;
+      handles.push_back(dummy_channel.TakeLocalEndpoint().TakePlatformHandle());
+      auto message = std::make_unique<Channel::Message>(size, 1);
+      char* payload = static_cast<char*>(message->mutable_payload());
+      for (size_t j = 0; j < size; ++j)
+        payload[j] = static_cast<char>(j * 7 + i);
+      message->SetHandles(std::move(handles));
+      sender->Write(std::move(message));
+
+      receiver_delegate.WaitForMessage();
+      ASSERT_FALSE(receiver_delegate.channel_error());
+      ASSERT_EQ(size, receiver_delegate.payload().size());
+      for (size_t j = 0; j < size; ++j)
+        ASSERT_EQ(static_cast<char>(j * 7 + i), receiver_delegate.payload()[j]);
+      ASSERT_EQ(1u, receiver_delegate.handles().size());
+      EXPECT_TRUE(receiver_delegate.handles()[0].is_valid());
+    }
+  }
+
+  receiver->ShutDown();
+  sender->ShutDown();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_FALSE(sender_delegate.channel_error());
+}
+
+// Same layout as LargeMessageHeader in channel_posix.cc.
+#pragma pack(push, 1)
+struct TestLargeMessageHeader {
+  uint64_t region_id;
+  uint64_t region_num_bytes;
+  uint64_t guid_high;
+  uint64_t guid_low;
+  uint32_t message_num_bytes;
+  uint32_t padding;
+};
+#pragma pack(pop)
+
+// A peer must not be able to make the receiver map more than the region
+// really holds, or map and copy more than the largest allowed message.
+TEST(ChannelTest, MalformedLargeMessages) {
+  const struct {
+    size_t actual_region_size;
+    uint64_t claimed_region_size;
+    uint32_t message_size;
+  } kCases[] = {
+      // The region is shorter than claimed; reading it would SIGBUS.
+      {4096, 1024 * 1024, 512 * 1024},
+      // The message is larger than any message the channel accepts.
+      {4096, std::numeric_limits<uint32_t>::max(),
+       std::numeric_limits<uint32_t>::max()},
+  };
+
+  for (const auto& test_case : kCases) {
+    SCOPED_TRACE(base::StringPrintf("message size %u", test_case.message_size));
+    base::test::SingleThreadTaskEnvironment task_environment(
+        base::test::TaskEnvironment::MainThreadType::IO);
+    PlatformChannel platform_channel;
+
+    LargeMessageDelegate receiver_delegate;
+    scoped_refptr<Channel> receiver =
+        Channel::Create(&receiver_delegate,
+                        ConnectionParams(platform_channel.TakeLocalEndpoint()),
+                        Channel::HandlePolicy::kAcceptHandles,
+                        base::ThreadTaskRunnerHandle::Get());
+    receiver->Start();
+
+    LargeMessageDelegate sender_delegate;
+    scoped_refptr<Channel> sender = Channel::Create(
+        &sender_delegate,
+        ConnectionParams(platform_channel.TakeRemoteEndpoint()),
+        Channel::HandlePolicy::kAcceptHandles,
+        base::ThreadTaskRunnerHandle::Get());
+    sender->Start();
+
+    base::UnsafeSharedMemoryRegion region =
+        base::UnsafeSharedMemoryRegion::Create(test_case.actual_region_size);
+    ASSERT_TRUE(region.IsValid());
+
+    auto message = std::make_unique<Channel::Message>(
+        sizeof(TestLargeMessageHeader), 1,
+        Channel::Message::MessageType::LARGE_MESSAGE);
+    auto* header =
+        static_cast<TestLargeMessageHeader*>(message->mutable_payload());
+    header->region_id = 0;
+    header->region_num_bytes = test_case.claimed_region_size;
+    header->guid_high = region.GetGUID().GetHighForSerialization();
+    header->guid_low = region.GetGUID().GetLowForSerialization();
+    header->message_num_bytes = test_case.message_size;
+    header->padding = 0;
+
+    PlatformHandle region_handle;
+    PlatformHandle unused_readonly_handle;
+    ExtractPlatformHandlesFromSharedMemoryRegionHandle(
+        base::UnsafeSharedMemoryRegion::TakeHandleForSerialization(
+            std::move(region))
+            .PassPlatformHandle(),
+        &region_handle, &unused_readonly_handle);
+    std::vector<PlatformHandle> handles;
+    handles.push_back(std::move(region_handle));
+    message->SetHandles(std::move(handles));
+    sender->Write(std::move(message));
+
+    receiver_delegate.WaitForMessage();
+    EXPECT_TRUE(receiver_delegate.channel_error());
+    EXPECT_TRUE(receiver_delegate.payload().empty());
+
+    receiver->ShutDown();
+    sender->ShutDown();
+    base::RunLoop().RunUntilIdle();
+  }
+}
+#endif  // defined(OS_POSIX) && !defined(OS_MACOSX) && !defined(OS_NACL)
+
 }  // namespace
 }  // namespace core
 }  // namespace mojo
@@ -77,11 +77,12 @@ class MessagePipePerfTest : public test::MojoTestBase {
 
  protected:
   void RunPingPongServer(MojoHandle mp) {
-    // This values are set to align with one at ipc_pertests.cc for comparison.
-    const size_t kMsgSize[5] = {12, 144, 1728, 20736, 248832};
-    const int kMessageCount[5] = {50000, 50000, 50000, 12000, 1000};
+    // This values are set to align with one at ipc_pertests.cc for comparison,
+    // plus a size large enough to go through shared memory on POSIX.
+    const size_t kMsgSize[6] = {12, 144, 1728, 20736, 248832, 2985984};
+    const int kMessageCount[6] = {50000, 50000, 50000, 12000, 1000, 100};
 
-    for (size_t i = 0; i < 5; i++) {
+    for (size_t i = 0; i < 6; i++) {
       SetUpMeasurement(kMessageCount[i], kMsgSize[i]);
       Measure(mp);
     }
@@ -760,6 +760,10 @@ void CookieMonster::StoreLoadedCookies(
   // removed, and sync'd.
   CookieItVector cookies_with_control_chars;
 
+  // Growing the map up front keeps the iterators in
+  // |cookies_with_control_chars| valid, as no insertion below can rehash.
+  cookies_.reserve(cookies_.size() + cookies.size());
+
   for (auto& cookie : cookies) {
     CanonicalCookie* cookie_ptr = cookie.get();
     auto inserted = InternalInsertCookie(GetKey(cookie_ptr->Domain()),
@@ -828,12 +832,14 @@ void CookieMonster::InvokeQueue() {
 void CookieMonster::EnsureCookiesMapIsValid() {
   DCHECK(thread_checker_.CalledOnValidThread());
 
-  // Iterate through all the of the cookies, grouped by host.
+  // Iterate through all the of the cookies, grouped by host. Cookies with the
+  // same key are adjacent in |cookies_|, so each range is visited once.
   auto prev_range_end = cookies_.begin();
   while (prev_range_end != cookies_.end()) {
-    auto cur_range_begin = prev_range_end;
-    const std::string key = cur_range_begin->first;  // Keep a copy.
-    auto cur_range_end = cookies_.upper_bound(key);
+    const std::string key = prev_range_end->first;  // Keep a copy.
+    CookieMapItPair cur_range = cookies_.equal_range(key);
+    auto cur_range_begin = cur_range.first;
+    auto cur_range_end = cur_range.second;
     prev_range_end = cur_range_end;
 
     // Ensure no equivalent cookies for this host.
@@ -911,8 +917,8 @@ void CookieMonster::TrimDuplicateCookiesForKey(const std::string& key,
         std::get<2>(signature).c_str());
 
     // Remove all the cookies identified by |dupes|. It is valid to delete our
-    // list of iterators one at a time, since |cookies_| is a multimap (they
-    // don't invalidate existing iterators following deletion).
+    // list of iterators one at a time, since erasing from |cookies_| only
+    // invalidates iterators to the erased element.
     for (auto dupes_it = dupes.begin(); dupes_it != dupes.end(); ++dupes_it) {
       InternalDeleteCookie(*dupes_it, true,
                            DELETE_COOKIE_DUPLICATE_IN_BACKING_STORE);
@@ -14,6 +14,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -90,17 +91,17 @@ class NET_EXPORT CookieMonster : public CookieStore {
   // excludes cookies for, e.g, ".com", ".co.uk", or ".internalnetwork".
   // This behavior is the same as the behavior in Firefox v 3.6.10.
 
-  // NOTE(deanm):
-  // I benchmarked hash_multimap vs multimap.  We're going to be query-heavy
-  // so it would seem like hashing would help.  However they were very
-  // close, with multimap being a tiny bit faster.  I think this is because
-  // our map is at max around 1000 entries, and the additional complexity
-  // for the hashing might not overcome the O(log(1000)) for querying
-  // a multimap.  Also, multimap is standard, another reason to use it.
-  // TODO(rdsmith): This benchmark should be re-done now that we're allowing
-  // substantially more entries in the map.
+  // The map is hashed rather than ordered: every cookie access does exactly one
+  // lookup by key, and nothing depends on the keys being sorted. With stores
+  // of tens of thousands of cookies or more, the O(log n) string comparisons
+  // of an ordered multimap dominate the lookup. Cookies with the same key are
+  // stored contiguously, so equal_range() still yields all of them.
+  //
+  // Inserting into the map may rehash it, which invalidates all iterators (but
+  // not pointers or references to the elements). Erasing an element only
+  // invalidates iterators to that element.
   using CookieMap =
-      std::multimap<std::string, std::unique_ptr<CanonicalCookie>>;
+      std::unordered_multimap<std::string, std::unique_ptr<CanonicalCookie>>;
   using CookieMapItPair = std::pair<CookieMap::iterator, CookieMap::iterator>;
   using CookieItVector = std::vector<CookieMap::iterator>;
 
@@ -439,7 +440,9 @@ class NET_EXPORT CookieMonster : public CookieStore {
       const CanonicalCookie& cookie) const;
 
   // Inserts |cc| into cookies_. Returns an iterator that points to the inserted
-  // cookie in cookies_. Guarantee: all iterators to cookies_ remain valid.
+  // cookie in cookies_. Iterators to cookies_ obtained before the call are
+  // invalidated if the insertion causes a rehash; use cookies_.reserve() to
+  // keep them valid across several insertions.
   CookieMap::iterator InternalInsertCookie(const std::string& key,
                                            std::unique_ptr<CanonicalCookie> cc,
                                            bool sync_to_store);
@@ -383,6 +383,62 @@ TEST_F(CookieMonsterTest, TestImport) {
   EXPECT_EQ("domain_1.com", cm->GetKey("www.Domain_1.com"));
 }
 
+// Measures lookups in stores much larger than kMaxCookies, as loaded from the
+// backing store before any garbage collection has had a chance to run. Each
+// domain holds a handful of cookies, so the time is dominated by finding the
+// cookies for a key rather than by filtering them.
+TEST_F(CookieMonsterTest, TestQueryLargeStore) {
+  const int kCookiesPerDomain = 10;
+  const struct TestCase {
+    const char* const name;
+    int num_cookies;
+  } test_cases[] = {
+      {"large_store_10k", 10000},
+      {"large_store_100k", 100000},
+      {"large_store_1m", 1000000},
+  };
+
+  for (const auto& test_case : test_cases) {
+    scoped_refptr<MockPersistentCookieStore> store(
+        new MockPersistentCookieStore);
+    std::vector<std::unique_ptr<CanonicalCookie>> initial_cookies;
+    // Creation times must be unique, and recent enough that loading the store
+    // doesn't make the cookies eligible for the global purge.
+    base::Time creation_time = base::Time::Now();
+    const int num_domains = test_case.num_cookies / kCookiesPerDomain;
+    for (int domain_num = 0; domain_num < num_domains; domain_num++) {
+      GURL gurl(base::StringPrintf("http://www.domain%d.com", domain_num));
+      for (int cookie_num = 0; cookie_num < kCookiesPerDomain; cookie_num++) {
+        creation_time -= base::TimeDelta::FromMicroseconds(1);
+        AddCookieToList(gurl,
+                        base::StringPrintf("Cookie_%d=1; Path=/", cookie_num),
+                        creation_time, &initial_cookies);
+      }
+    }
+    store->SetLoadExpectation(true, std::move(initial_cookies));
+    auto cm = std::make_unique<CookieMonster>(store.get(), nullptr);
+
+    std::vector<GURL> gurls;
+    for (int i = 0; i < kNumCookies; i++) {
+      gurls.push_back(GURL(base::StringPrintf(
+          "http://www.domain%d.com/", (i * 7919) % num_domains)));
+    }
+
+    GetCookieListCallback getCookieListCallback;
+    // Import everything before starting the clock.
+    getCookieListCallback.GetCookieList(cm.get(), gurls[0]);
+
+    auto reporter = SetUpCookieMonsterReporter(test_case.name);
+    base::ElapsedTimer query_timer;
+    for (const GURL& gurl : gurls) {
+      EXPECT_EQ(static_cast<size_t>(kCookiesPerDomain),
+                getCookieListCallback.GetCookieList(cm.get(), gurl).size());
+    }
+    reporter.AddResult(kMetricQueryTimeMs,
+                       query_timer.Elapsed().InMillisecondsF());
+  }
+}
+
 TEST_F(CookieMonsterTest, TestGetKey) {
   std::unique_ptr<CookieMonster> cm(new CookieMonster(nullptr, nullptr));
   auto reporter = SetUpCookieMonsterReporter("baseline_story");
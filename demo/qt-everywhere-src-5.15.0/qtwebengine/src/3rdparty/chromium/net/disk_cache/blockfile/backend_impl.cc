@@ -61,6 +61,10 @@ const int kBaseTableLen = 64 * 1024;
 // Avoid trimming the cache for the first 5 minutes (10 timer ticks).
 const int kTrimDelay = 10;
 
+// Minimum time between two read-driven moves of an open entry to the head of
+// its rankings list.
+const int kReadRankUpdateSeconds = 10;
+
 int DesiredIndexTableLen(int32_t storage_size) {
   if (storage_size <= k64kEntriesStore)
     return kBaseTableLen;
@@ -796,6 +800,21 @@ LruData* BackendImpl::GetLruData() {
 void BackendImpl::UpdateRank(EntryImpl* entry, bool modified) {
   if (read_only_ || (!modified && GetCacheType() == net::SHADER_CACHE))
     return;
+
+  // Moving an entry to the head of its list also rewrites the rankings nodes of
+  // its old and new neighbors. Reads of an open entry usually come in bursts,
+  // so reads move the entry at most once every few seconds, and the rest just
+  // refresh its access time, which is saved along with the node when the entry
+  // is closed. An entry that stays open and keeps being read still moves, so it
+  // doesn't drift towards the tail of the list and get evicted.
+  TimeTicks now = TimeTicks::Now();
+  if (!modified &&
+      now - entry->last_rank_update() <
+          TimeDelta::FromSeconds(kReadRankUpdateSeconds)) {
+    entry->SetTimes(Time::Now(), entry->GetLastModified());
+    return;
+  }
+  entry->set_last_rank_update(now);
   eviction_.UpdateRank(entry, modified);
 }
 
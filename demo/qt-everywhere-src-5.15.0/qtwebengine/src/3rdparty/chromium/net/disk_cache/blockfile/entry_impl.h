@@ -11,6 +11,7 @@
 #include <string>
 
 #include "base/macros.h"
+#include "base/time/time.h"
 #include "net/base/net_export.h"
 #include "net/disk_cache/blockfile/disk_format.h"
 #include "net/disk_cache/blockfile/storage_block-inl.h"
@@ -119,6 +120,12 @@ class NET_EXPORT_PRIVATE EntryImpl
     return dirty_;
   }
 
+  // When this entry was last moved to the head of its rankings list while open,
+  // or null if it wasn't. Used to rate-limit read-driven moves; see
+  // BackendImpl::UpdateRank().
+  base::TimeTicks last_rank_update() const { return last_rank_update_; }
+  void set_last_rank_update(base::TimeTicks time) { last_rank_update_ = time; }
+
   bool doomed() {
     return doomed_;
   }
@@ -310,6 +317,7 @@ class NET_EXPORT_PRIVATE EntryImpl
   bool doomed_;               // True if this entry was removed from the cache.
   bool read_only_;            // True if not yet writing.
   bool dirty_;                // True if we detected that this is a dirty entry.
+  base::TimeTicks last_rank_update_;  // Last move in rankings, if any.
   std::unique_ptr<SparseControl> sparse_;  // Support for sparse entries.
 
   DISALLOW_COPY_AND_ASSIGN(EntryImpl);
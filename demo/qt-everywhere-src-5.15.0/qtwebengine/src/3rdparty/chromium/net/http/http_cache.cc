@@ -56,6 +56,14 @@
 
 namespace net {
 
+namespace {
+
+// The maximum number of entries whose response info is kept in
+// |response_info_cache_|.
+const size_t kMaxCachedResponseInfos = 1000;
+
+}  // namespace
+
 const char HttpCache::kDoubleKeyPrefix[] = "_dk_";
 const char HttpCache::kDoubleKeySeparator[] = " ";
 
@@ -171,6 +179,27 @@ struct HttpCache::PendingOp {
 
 //-----------------------------------------------------------------------------
 
+struct HttpCache::CachedResponseInfo {
+  CachedResponseInfo() = default;
+  ~CachedResponseInfo() = default;
+
+  // Returns the estimate of dynamically allocated memory in bytes.
+  size_t EstimateMemoryUsage() const {
+    return base::trace_event::EstimateMemoryUsage(
+        response.headers->raw_headers());
+  }
+
+  HttpResponseInfo response;
+  bool truncated = false;
+
+  // The size of the response info stream and the modification time of the
+  // entry, to catch changes made to the entry behind the HttpCache's back.
+  int32_t data_size = 0;
+  base::Time last_modified;
+};
+
+//-----------------------------------------------------------------------------
+
 // A work item encapsulates a single request to the backend with all the
 // information needed to complete that request.
 class HttpCache::WorkItem {
@@ -256,6 +285,7 @@ HttpCache::HttpCache(std::unique_ptr<HttpTransactionFactory> network_layer,
       fail_conditionalization_for_test_(false),
       mode_(NORMAL),
       network_layer_(std::move(network_layer)),
+      response_info_cache_(kMaxCachedResponseInfos),
       clock_(base::DefaultClock::GetInstance()) {
   HttpNetworkSession* session = network_layer_->GetSession();
   // Session may be NULL in unittests.
@@ -417,7 +447,8 @@ void HttpCache::DumpMemoryStats(base::trace_event::ProcessMemoryDump* pmd,
   size_t size = base::trace_event::EstimateMemoryUsage(active_entries_) +
                 base::trace_event::EstimateMemoryUsage(doomed_entries_) +
                 base::trace_event::EstimateMemoryUsage(playback_cache_map_) +
-                base::trace_event::EstimateMemoryUsage(pending_ops_);
+                base::trace_event::EstimateMemoryUsage(pending_ops_) +
+                base::trace_event::EstimateMemoryUsage(response_info_cache_);
   if (disk_cache_)
     size += disk_cache_->DumpMemoryStats(pmd, name);
 
@@ -582,6 +613,7 @@ int HttpCache::DoomEntry(const std::string& key, Transaction* transaction) {
 
   std::unique_ptr<ActiveEntry> entry = std::move(it->second);
   active_entries_.erase(it);
+  RemoveCachedResponseInfo(key);
 
   // We keep track of doomed entries so that we can ensure that they are
   // cleaned up properly when the cache is destroyed.
@@ -598,6 +630,7 @@ int HttpCache::DoomEntry(const std::string& key, Transaction* transaction) {
 
 int HttpCache::AsyncDoomEntry(const std::string& key,
                               Transaction* transaction) {
+  RemoveCachedResponseInfo(key);
   PendingOp* pending_op = GetPendingOp(key);
   int rv =
       CreateAndSetWorkItem(nullptr, transaction, WI_DOOM_ENTRY, pending_op);
@@ -779,6 +812,7 @@ int HttpCache::CreateEntry(const std::string& key,
   if (FindActiveEntry(key)) {
     return ERR_CACHE_RACE;
   }
+  RemoveCachedResponseInfo(key);
 
   PendingOp* pending_op = GetPendingOp(key);
   int rv =
@@ -1187,6 +1221,54 @@ bool HttpCache::IsWritingInProgress(ActiveEntry* entry) const {
   return entry->writers.get();
 }
 
+bool HttpCache::GetCachedResponseInfo(const std::string& key,
+                                      ActiveEntry* entry,
+                                      HttpResponseInfo* response_info,
+                                      bool* response_truncated) {
+  if (entry->doomed)
+    return false;
+  auto it = response_info_cache_.Get(key);
+  if (it == response_info_cache_.end())
+    return false;
+
+  const CachedResponseInfo& cached = *it->second;
+  if (cached.data_size !=
+          entry->disk_entry->GetDataSize(kResponseInfoIndex) ||
+      cached.last_modified != entry->disk_entry->GetLastModified()) {
+    response_info_cache_.Erase(it);
+    return false;
+  }
+
+  *response_info = cached.response;
+  // Transactions may update their headers in place, so each one gets its own.
+  response_info->headers = base::MakeRefCounted<HttpResponseHeaders>(
+      cached.response.headers->raw_headers());
+  *response_truncated = cached.truncated;
+  return true;
+}
+
+void HttpCache::SetCachedResponseInfo(const std::string& key,
+                                      ActiveEntry* entry,
+                                      const HttpResponseInfo& response_info,
+                                      bool response_truncated) {
+  if (entry->doomed)
+    return;
+  auto cached = std::make_unique<CachedResponseInfo>();
+  cached->response = response_info;
+  cached->response.headers = base::MakeRefCounted<HttpResponseHeaders>(
+      response_info.headers->raw_headers());
+  cached->truncated = response_truncated;
+  cached->data_size = entry->disk_entry->GetDataSize(kResponseInfoIndex);
+  cached->last_modified = entry->disk_entry->GetLastModified();
+  response_info_cache_.Put(key, std::move(cached));
+}
+
+void HttpCache::RemoveCachedResponseInfo(const std::string& key) {
+  auto it = response_info_cache_.Peek(key);
+  if (it != response_info_cache_.end())
+    response_info_cache_.Erase(it);
+}
+
 LoadState HttpCache::GetLoadStateForPendingTransaction(
     const Transaction* transaction) {
   auto i = active_entries_.find(transaction->key());
@@ -20,6 +20,7 @@
 #include <string>
 #include <unordered_map>
 
+#include "base/containers/mru_cache.h"
 #include "base/files/file_path.h"
 #include "base/macros.h"
 #include "base/memory/weak_ptr.h"
@@ -307,6 +308,7 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory {
   friend class TestHttpCache;
   friend class Transaction;
   struct PendingOp;  // Info for an entry under construction.
+  struct CachedResponseInfo;  // Parsed response info of an entry.
 
   // To help with testing.
   friend class MockHttpCache;
@@ -395,6 +397,8 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory {
   using PendingOpsMap = std::unordered_map<std::string, PendingOp*>;
   using ActiveEntriesSet = std::map<ActiveEntry*, std::unique_ptr<ActiveEntry>>;
   using PlaybackCacheMap = std::unordered_map<std::string, int>;
+  using ResponseInfoCache =
+      base::HashingMRUCache<std::string, std::unique_ptr<CachedResponseInfo>>;
 
   // Methods ------------------------------------------------------------------
 
@@ -591,6 +595,25 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory {
   // Returns true if a transaction is currently writing the response body.
   bool IsWritingInProgress(ActiveEntry* entry) const;
 
+  // Copies the response info remembered for |entry| into |response_info| and
+  // |response_truncated|. Returns false if there is none, or if the entry was
+  // modified since it was remembered.
+  bool GetCachedResponseInfo(const std::string& key,
+                             ActiveEntry* entry,
+                             HttpResponseInfo* response_info,
+                             bool* response_truncated);
+
+  // Remembers the response info that was read from |entry|, so that the next
+  // transaction opening it doesn't need to read and parse it again.
+  void SetCachedResponseInfo(const std::string& key,
+                             ActiveEntry* entry,
+                             const HttpResponseInfo& response_info,
+                             bool response_truncated);
+
+  // Forgets the response info remembered for |key|. Must be called before the
+  // response info of the entry is written, and when the entry is doomed.
+  void RemoveCachedResponseInfo(const std::string& key);
+
   // Returns the LoadState of the provided pending transaction.
   LoadState GetLoadStateForPendingTransaction(const Transaction* transaction);
 
@@ -666,6 +689,9 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory {
 
   std::unique_ptr<PlaybackCacheMap> playback_cache_map_;
 
+  // Response info of recently read entries, indexed by cache key.
+  ResponseInfoCache response_info_cache_;
+
   // A clock that can be swapped out for testing.
   base::Clock* clock_;
 
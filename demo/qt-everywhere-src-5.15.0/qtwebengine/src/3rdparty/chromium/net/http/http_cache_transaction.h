@@ -604,6 +604,7 @@ class NET_EXPORT_PRIVATE HttpCache::Transaction : public HttpTransaction {
   bool reading_;  // We are already reading. Never reverts to false once set.
   bool invalid_range_;  // We may bypass the cache for this request.
   bool truncated_;  // We don't have all the response data.
+  bool read_response_info_from_memory_;  // Parsed response info was reused.
   bool is_sparse_;  // The data is stored in sparse byte ranges.
   bool range_requested_;  // The user requested a byte range.
   bool handling_206_;  // We must deal with this 206 response.
@@ -645,6 +646,7 @@ class NET_EXPORT_PRIVATE HttpCache::Transaction : public HttpTransaction {
   base::TimeTicks first_cache_access_since_;
   base::TimeTicks send_request_since_;
   base::TimeTicks read_headers_since_;
+  base::TimeTicks read_response_info_since_;
   base::Time open_entry_last_used_;
   bool cant_conditionalize_zero_freshness_from_memhint_;
   bool recorded_histograms_;
@@ -1102,6 +1102,47 @@ TEST_F(HttpCacheTest, SimpleGET_LoadOnlyFromCache_Hit) {
   TestLoadTimingCachedResponse(load_timing_info);
 }
 
+// Tests that the response info read from an entry is reused by the next
+// transaction reading it, and not after the entry was modified.
+TEST_F(HttpCacheTest, SimpleGET_ResponseInfoMemoryHit) {
+  MockHttpCache cache;
+  base::HistogramTester histograms;
+  const std::string histogram_name = "HttpCache.ResponseInfoMemoryHit";
+
+  // Write to the cache, then read from it twice.
+  RunTransactionTest(cache.http_cache(), kSimpleGET_Transaction);
+  std::string disk_headers;
+  RunTransactionTestWithResponse(cache.http_cache(), kSimpleGET_Transaction,
+                                 &disk_headers);
+  histograms.ExpectUniqueSample(histogram_name, false, 1);
+  std::string headers;
+  RunTransactionTestWithResponse(cache.http_cache(), kSimpleGET_Transaction,
+                                 &headers);
+  histograms.ExpectBucketCount(histogram_name, true, 1);
+  EXPECT_EQ(disk_headers, headers);
+
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(2, cache.disk_cache()->open_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+
+  // Change the stored headers behind the cache's back.
+  MockHttpRequest request(kSimpleGET_Transaction);
+  disk_cache::Entry* entry;
+  ASSERT_TRUE(cache.OpenBackendEntry(request.CacheKey(), &entry));
+  HttpResponseInfo response;
+  bool truncated;
+  ASSERT_TRUE(MockHttpCache::ReadResponseInfo(entry, &response, &truncated));
+  response.headers->AddHeader("X-Changed: 1");
+  ASSERT_TRUE(MockHttpCache::WriteResponseInfo(entry, &response, true, false));
+  entry->Close();
+
+  RunTransactionTestWithResponse(cache.http_cache(), kSimpleGET_Transaction,
+                                 &headers);
+  histograms.ExpectBucketCount(histogram_name, false, 2);
+  EXPECT_EQ(disk_headers + "X-Changed: 1\n", headers);
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+}
+
 TEST_F(HttpCacheTest, SimpleGET_LoadOnlyFromCache_Miss) {
   MockHttpCache cache;
 
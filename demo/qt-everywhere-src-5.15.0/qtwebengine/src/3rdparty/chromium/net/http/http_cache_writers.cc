@@ -256,6 +256,7 @@ void HttpCache::Writers::TruncateEntry() {
                                     true /* response_truncated */);
   data->Done();
   io_buf_len_ = data->pickle()->size();
+  cache_->RemoveCachedResponseInfo(entry_->disk_entry->GetKey());
   entry_->disk_entry->WriteData(kResponseInfoIndex, 0, data.get(), io_buf_len_,
                                 base::DoNothing(), true);
 }
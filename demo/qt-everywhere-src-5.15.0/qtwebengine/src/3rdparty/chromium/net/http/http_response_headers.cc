@@ -9,6 +9,9 @@
 
 #include "net/http/http_response_headers.h"
 
+#include <stdint.h>
+#include <string.h>
+
 #include <algorithm>
 #include <limits>
 #include <memory>
@@ -124,11 +127,19 @@ bool ShouldUpdateHeader(base::StringPiece name) {
 }
 
 bool HasEmbeddedNulls(base::StringPiece str) {
-  for (char c : str) {
-    if (c == '\0')
-      return true;
+  return !str.empty() && memchr(str.data(), '\0', str.size()) != nullptr;
+}
+
+// Returns a case-insensitive (FNV-1a) hash of a header name. Each parsed
+// header stores the hash of its name, which lets FindHeader() skip the string
+// comparison for nearly all the headers that don't match.
+uint32_t HashHeaderName(base::StringPiece name) {
+  uint32_t hash = 2166136261u;
+  for (char c : name) {
+    hash ^= static_cast<uint8_t>(base::ToLowerASCII(c));
+    hash *= 16777619u;
   }
-  return false;
+  return hash;
 }
 
 void CheckDoesNotHaveEmbeddedNulls(base::StringPiece str) {
@@ -151,6 +162,9 @@ struct HttpResponseHeaders::ParsedHeader {
   std::string::const_iterator name_end;
   std::string::const_iterator value_begin;
   std::string::const_iterator value_end;
+
+  // HashHeaderName() of the name, or 0 for continuations.
+  uint32_t name_hash;
 };
 
 //-----------------------------------------------------------------------------
@@ -478,6 +492,10 @@ void HttpResponseHeaders::Parse(const std::string& raw_input) {
   // Adjust to point at the null byte following the status line
   line_end = raw_headers_.begin() + status_line_len - 1;
 
+  // Most lines hold a single header, so this avoids growing parsed_ while
+  // parsing.
+  parsed_.reserve(std::count(line_end + 1, raw_headers_.cend(), '\0'));
+
   HttpUtil::HeadersIterator headers(line_end + 1, raw_headers_.end(),
                                     std::string(1, '\0'));
   while (headers.GetNext()) {
@@ -732,8 +750,9 @@ void HttpResponseHeaders::ParseStatusLine(
 
 size_t HttpResponseHeaders::FindHeader(size_t from,
                                        const base::StringPiece& search) const {
+  const uint32_t search_hash = HashHeaderName(search);
   for (size_t i = from; i < parsed_.size(); ++i) {
-    if (parsed_[i].is_continuation())
+    if (parsed_[i].name_hash != search_hash || parsed_[i].is_continuation())
       continue;
     base::StringPiece name(parsed_[i].name_begin, parsed_[i].name_end);
     if (base::EqualsCaseInsensitiveASCII(search, name))
@@ -797,6 +816,9 @@ void HttpResponseHeaders::AddToParsed(std::string::const_iterator name_begin,
   header.name_end = name_end;
   header.value_begin = value_begin;
   header.value_end = value_end;
+  header.name_hash = name_begin == name_end
+                         ? 0
+                         : HashHeaderName(base::StringPiece(name_begin, name_end));
   parsed_.push_back(header);
 }
 
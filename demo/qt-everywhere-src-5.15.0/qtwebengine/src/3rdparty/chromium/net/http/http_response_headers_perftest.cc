@@ -0,0 +1,81 @@
+// Copyright 2020 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/http/http_response_headers.h"
+
+#include <string>
+
+#include "base/logging.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/timer/elapsed_timer.h"
+#include "net/http/http_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace net {
+namespace {
+
+// Headers of a typical response to an XHR, as received from the network.
+const char kRepresentativeResponse[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Date: Tue, 02 Jun 2020 10:21:47 GMT\r\n"
+    "Content-Type: application/json; charset=utf-8\r\n"
+    "Content-Length: 2419\r\n"
+    "Connection: keep-alive\r\n"
+    "Cache-Control: private, max-age=0, must-revalidate\r\n"
+    "ETag: W/\"973-dPb8TNsPyeAxK5qYcB2Z1ngvrDQ\"\r\n"
+    "Last-Modified: Tue, 02 Jun 2020 10:20:13 GMT\r\n"
+    "Vary: Accept-Encoding, Origin\r\n"
+    "Access-Control-Allow-Origin: http://localhost:8080\r\n"
+    "Access-Control-Allow-Credentials: true\r\n"
+    "Set-Cookie: session=4d1ac4c1e1ff4bd6a5f3; Path=/; HttpOnly\r\n"
+    "Strict-Transport-Security: max-age=31536000\r\n"
+    "X-Content-Type-Options: nosniff\r\n"
+    "X-Frame-Options: SAMEORIGIN\r\n"
+    "X-Request-Id: 0b6e1f3c-96b5-4b50-a0c5-3f4b9dd1e2a7\r\n"
+    "Server: nginx\r\n"
+    "\r\n";
+
+// Header lookups done for most responses by the network stack.
+const char* const kLookedUpHeaders[] = {
+    "content-type", "content-length", "cache-control", "date",
+    "expires",      "last-modified",  "etag",          "vary",
+};
+
+TEST(HttpResponseHeadersPerfTest, ParseAndLookUp) {
+  const size_t kWarmupIterations = 1000;
+  const size_t kMeasuredIterations = 100000;
+  const base::StringPiece input(kRepresentativeResponse);
+
+  size_t found = 0;
+  auto run = [&](size_t iterations) {
+    for (size_t i = 0; i < iterations; ++i) {
+      auto headers = base::MakeRefCounted<HttpResponseHeaders>(
+          HttpUtil::AssembleRawHeaders(input));
+      for (const char* name : kLookedUpHeaders) {
+        if (headers->HasHeader(name))
+          found++;
+      }
+    }
+  };
+
+  run(kWarmupIterations);
+  base::ElapsedTimer elapsed_timer;
+  run(kMeasuredIterations);
+  base::TimeDelta elapsed = elapsed_timer.Elapsed();
+  CHECK_EQ((kWarmupIterations + kMeasuredIterations) * 7, found);
+
+  perf_test::PerfResultReporter reporter("HttpResponseHeaders.",
+                                         "ParseAndLookUp");
+  reporter.RegisterImportantMetric("throughput", "runs/s");
+  reporter.RegisterImportantMetric("time_per_response", "ns");
+  reporter.AddResult("throughput",
+                     kMeasuredIterations / elapsed.InSecondsF());
+  reporter.AddResult("time_per_response",
+                     static_cast<size_t>(elapsed.InNanoseconds() /
+                                         kMeasuredIterations));
+}
+
+}  // namespace
+}  // namespace net
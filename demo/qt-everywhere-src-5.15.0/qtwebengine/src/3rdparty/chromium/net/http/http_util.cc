@@ -7,6 +7,8 @@
 
 #include "net/http/http_util.h"
 
+#include <string.h>
+
 #include <algorithm>
 
 #include "base/logging.h"
@@ -705,9 +707,44 @@ static base::StringPiece RemoveLeadingNonLWS(base::StringPiece str) {
   return base::StringPiece();  // Remove everything.
 }
 
+// Helper used by AssembleRawHeaders, to find the first '\r' or '\n' in
+// [begin, end). Header lines are nearly always terminated by CRLF, so rather
+// than testing every byte against both characters, this looks for the LF with
+// memchr(), which the C library vectorizes, and then for a CR in the (usually
+// short) line before it. |next_lf| caches the LF found by the previous call,
+// so that inputs using CR alone as a line break aren't rescanned for every
+// line.
+static const char* FindLineBreak(const char* begin,
+                                 const char* end,
+                                 const char** next_lf) {
+  if (!*next_lf || *next_lf < begin) {
+    const char* lf =
+        static_cast<const char*>(memchr(begin, '\n', end - begin));
+    *next_lf = lf ? lf : end;
+  }
+  const char* cr =
+      static_cast<const char*>(memchr(begin, '\r', *next_lf - begin));
+  return cr ? cr : *next_lf;
+}
+
+// Helper used by AssembleRawHeaders, to append |str| to |output|, dropping any
+// embedded '\0' characters if |strip_nulls| is true.
+static void AppendHeaderPiece(base::StringPiece str,
+                              bool strip_nulls,
+                              std::string* output) {
+  if (!strip_nulls) {
+    str.AppendToString(output);
+    return;
+  }
+  for (char c : str) {
+    if (c != '\0')
+      output->push_back(c);
+  }
+}
+
 std::string HttpUtil::AssembleRawHeaders(base::StringPiece input) {
   std::string raw_headers;
-  raw_headers.reserve(input.size());
+  raw_headers.reserve(input.size() + 2);
 
   // Skip any leading slop, since the consumers of this output
   // (HttpResponseHeaders) don't deal with it.
@@ -716,50 +753,56 @@ std::string HttpUtil::AssembleRawHeaders(base::StringPiece input) {
   if (status_begin_offset != std::string::npos)
     input.remove_prefix(status_begin_offset);
 
+  // Use '\0' as the canonical line terminator. If the input already contained
+  // any embeded '\0' characters we will strip them while copying to avoid
+  // interpreting them as line breaks.
+  const bool strip_nulls =
+      !input.empty() && memchr(input.data(), '\0', input.size()) != nullptr;
+
   // Copy the status line.
   size_t status_line_end = FindStatusLineEnd(input);
-  input.substr(0, status_line_end).AppendToString(&raw_headers);
+  AppendHeaderPiece(input.substr(0, status_line_end), strip_nulls,
+                    &raw_headers);
   input.remove_prefix(status_line_end);
 
   // After the status line, every subsequent line is a header line segment.
   // Should a segment start with LWS, it is a continuation of the previous
   // line's field-value.
 
-  // TODO(ericroman): is this too permissive? (delimits on [\r\n]+)
-  base::CStringTokenizer lines(input.data(), input.data() + input.size(),
-                               "\r\n");
-
   // This variable is true when the previous line was continuable.
   bool prev_line_continuable = false;
 
-  while (lines.GetNext()) {
-    base::StringPiece line = lines.token_piece();
+  // TODO(ericroman): is this too permissive? (delimits on [\r\n]+)
+  const char* p = input.data();
+  const char* const end = input.data() + input.size();
+  const char* next_lf = nullptr;
+  while (p < end) {
+    // Skip the line break(s), ignoring empty lines.
+    if (*p == '\r' || *p == '\n') {
+      ++p;
+      continue;
+    }
+    const char* line_end = FindLineBreak(p, end, &next_lf);
+    base::StringPiece line(p, line_end - p);
+    p = line_end;
 
     if (prev_line_continuable && IsLWS(line[0])) {
       // Join continuation; reduce the leading LWS to a single SP.
       raw_headers.push_back(' ');
-      RemoveLeadingNonLWS(line).AppendToString(&raw_headers);
+      AppendHeaderPiece(RemoveLeadingNonLWS(line), strip_nulls, &raw_headers);
     } else {
       // Terminate the previous line.
-      raw_headers.push_back('\n');
+      raw_headers.push_back('\0');
 
       // Copy the raw data to output.
-      line.AppendToString(&raw_headers);
+      AppendHeaderPiece(line, strip_nulls, &raw_headers);
 
       // Check if the current line can be continued.
       prev_line_continuable = IsLineSegmentContinuable(line);
     }
   }
 
-  raw_headers.append("\n\n", 2);
-
-  // Use '\0' as the canonical line terminator. If the input already contained
-  // any embeded '\0' characters we will strip them first to avoid interpreting
-  // them as line breaks.
-  base::Erase(raw_headers, '\0');
-
-  std::replace(raw_headers.begin(), raw_headers.end(), '\n', '\0');
-
+  raw_headers.append(2, '\0');
   return raw_headers;
 }
 
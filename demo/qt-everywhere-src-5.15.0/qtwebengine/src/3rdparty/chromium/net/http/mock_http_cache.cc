@@ -91,7 +91,8 @@ MockDiskEntry::MockDiskEntry(const std::string& key)
       delayed_(false),
       cancel_(false),
       defer_op_(DEFER_NONE),
-      resume_return_code_(0) {
+      resume_return_code_(0),
+      last_modified_(base::Time::Now()) {
   test_mode_ = GetTestModeForEntry(key);
 }
 
@@ -112,7 +113,7 @@ base::Time MockDiskEntry::GetLastUsed() const {
 }
 
 base::Time MockDiskEntry::GetLastModified() const {
-  return base::Time::Now();
+  return last_modified_;
 }
 
 int32_t MockDiskEntry::GetDataSize(int index) const {
@@ -185,6 +186,10 @@ int MockDiskEntry::WriteData(int index,
   data_[index].resize(offset + buf_len);
   if (buf_len)
     memcpy(&data_[index][offset], buf->data(), buf_len);
+  // Keep the modification time increasing even if the clock is coarse.
+  last_modified_ =
+      std::max(base::Time::Now(),
+               last_modified_ + base::TimeDelta::FromMicroseconds(1));
 
   if (MockHttpCache::GetTestMode(test_mode_) & TEST_MODE_SYNC_CACHE_WRITE)
     return buf_len;
@@ -153,6 +153,8 @@ class MockDiskEntry : public disk_cache::Entry,
   CompletionOnceCallback resume_callback_;
   int resume_return_code_;
 
+  base::Time last_modified_;
+
   static bool ignore_callbacks_;
 };
 